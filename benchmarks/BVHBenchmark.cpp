@@ -0,0 +1,115 @@
+// The benchmarks load the obj-files themselves, since they do not link the rendering:
+#define TINYOBJLOADER_IMPLEMENTATION
+#define TINYOBJLOADER_USE_MAPBOX_EARCUT
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#include "BenchmarkModels.h"
+#include "geometry/BVH.h"
+#include "geometry/ClosestPointQuery.h"
+#include "geometry/RayQuery.h"
+#include "utilities/Random.h"
+
+/* The number of closest point and ray queries per model: */
+#define QUERY_COUNT (1 << 18)
+
+/* The number of builds per model, of which the fastest one is reported: */
+#define BUILD_REPETITIONS 3
+
+namespace
+{
+	/**
+	 * \brief Returns a random float in [min, max].
+	 */
+	float random_float(uint64_t stream, uint64_t counter, float min, float max)
+	{
+		return min + (max - min) * Utilities::to_unit_float(Utilities::random_bits(stream, counter));
+	}
+
+	/**
+	 * \brief Builds the BVH of a model and times its queries.
+	 */
+	void run(const std::string& file_name, const BenchmarkModel& model)
+	{
+		double build_ms = 0.0;
+		for (int repetition = 0; repetition < BUILD_REPETITIONS; repetition++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			const BVH bvh(model.triangles);
+			const double ms = milliseconds_since(start);
+			build_ms = repetition == 0 ? ms : std::min(build_ms, ms);
+		}
+		const BVH bvh(model.triangles);
+
+		// the queries start in the bounds of the model enlarged by half of their size
+		const BVHNode& root = bvh.get_nodes()[0];
+		float min[3], max[3];
+		for (int i = 0; i < 3; i++)
+		{
+			const float margin = 0.5f * (root.bounds_max[i] - root.bounds_min[i]);
+			min[i] = root.bounds_min[i] - margin;
+			max[i] = root.bounds_max[i] + margin;
+		}
+
+		const uint64_t stream = Utilities::random_stream(0x42);
+		std::vector<Vec4f> points(QUERY_COUNT);
+		std::vector<Ray> rays(QUERY_COUNT);
+		for (uint64_t q = 0; q < QUERY_COUNT; q++)
+		{
+			const Vec4f origin(random_float(stream, 6 * q, min[0], max[0]), random_float(stream, 6 * q + 1, min[1], max[1]),
+				random_float(stream, 6 * q + 2, min[2], max[2]));
+			const Vec4f direction(random_float(stream, 6 * q + 3, -1.f, 1.f), random_float(stream, 6 * q + 4, -1.f, 1.f),
+				random_float(stream, 6 * q + 5, -1.f, 1.f), 0.f);
+			points[q] = origin;
+			rays[q] = Ray(origin, direction.normalized());
+		}
+
+		std::vector<ClosestPointResult> results(QUERY_COUNT);
+		auto start = std::chrono::steady_clock::now();
+		ClosestPointQuery(bvh).find(points.data(), points.size(), results.data());
+		const double closest_ms = milliseconds_since(start);
+
+		std::vector<RayHit> hits(QUERY_COUNT);
+		start = std::chrono::steady_clock::now();
+		RayQuery(bvh).intersect(rays.data(), rays.size(), hits.data());
+		const double ray_ms = milliseconds_since(start);
+
+		size_t hit_count = 0;
+		for (const RayHit& hit : hits)
+			hit_count += hit.triangle != RayQuery::NO_TRIANGLE;
+
+		std::cout << std::left << std::setw(26) << file_name << std::right
+			<< std::setw(10) << model.triangles.size()
+			<< std::setw(10) << bvh.get_nodes().size()
+			<< std::setw(12) << std::fixed << std::setprecision(2) << build_ms
+			<< std::setw(14) << closest_ms
+			<< std::setw(12) << ray_ms
+			<< std::setw(9) << std::setprecision(1) << 100.0 * hit_count / QUERY_COUNT << "%" << std::endl;
+	}
+}
+
+/**
+ * \brief Times the construction of the BVH and the closest point and ray queries on all threads for the given
+ * models, or all bundled models without arguments.
+ * The queries are the same on every run: points and rays from random positions around the model.
+ */
+int main(int argc, char** argv)
+{
+	std::vector<std::string> file_names = BENCHMARK_MODELS;
+	if (argc > 1)
+		file_names.assign(argv + 1, argv + argc);
+
+	std::cout << std::left << std::setw(26) << "model" << std::right << std::setw(10) << "triangles" << std::setw(10) << "nodes"
+		<< std::setw(12) << "build ms" << std::setw(14) << "closest ms" << std::setw(12) << "ray ms" << std::setw(10) << "ray hits"
+		<< "   (" << QUERY_COUNT << " queries each)" << std::endl;
+	for (const std::string& file_name : file_names)
+	{
+		BenchmarkModel model;
+		if (!load_benchmark_model(file_name, model) || model.triangles.empty())
+			continue;
+		run(file_name, model);
+	}
+	return EXIT_SUCCESS;
+}
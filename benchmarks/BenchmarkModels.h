@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "math/Vec3f.h"
+#include "primitives/Triangle.h"
+#include "tiny_obj_loader.h"
+
+/* The models of the benchmarks, relative to the models directory: */
+#define BENCHMARK_MODELS { "cube.obj", "suzanne.obj", "table.obj", "container_sm.obj", "container.obj", "SpinningTop.obj", \
+	"Ground.obj", "island.obj", "world.obj", "teapot/teapot.obj", "teapot/teapot_scaled.obj" }
+
+/**
+ * \brief A model of the benchmarks, loaded like 'Mesh::uploadData' but without uploading it.
+ */
+struct BenchmarkModel
+{
+	/**
+	 * \brief The triangles in the order of the obj.
+	 */
+	std::vector<Triangle> triangles;
+
+	/**
+	 * \brief The position index of each triangle corner. (3 per triangle)
+	 */
+	std::vector<uint32_t> indices;
+
+	/**
+	 * \brief The shared positions of the obj.
+	 */
+	std::vector<Vec3f> positions;
+};
+
+/**
+ * \brief Loads a model of the models directory.
+ * \param file_name The name of the obj-file.
+ * \param model The loaded model.
+ * \return True if the model was loaded.
+ */
+inline bool load_benchmark_model(const std::string& file_name, BenchmarkModel& model)
+{
+	const std::string filePath = CMAKE_SOURCE_DIR "/models/" + file_name;
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::shape_t> shapes;
+	std::vector<tinyobj::material_t> materials;
+	std::string warn;
+	std::string err;
+	if (!LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath.c_str()) || !err.empty())
+	{
+		std::cerr << "Obj-file " << filePath << " could not be loaded. " << err << std::endl;
+		return false;
+	}
+
+	model = BenchmarkModel();
+	for (auto& shape : shapes)
+	{
+		size_t index_offset = 0;
+		for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++)
+		{
+			const int fv = shape.mesh.num_face_vertices[f];
+			Triangle triangle;
+			for (int v = 0; v < fv; v++)
+			{
+				const tinyobj::index_t idx = shape.mesh.indices[index_offset + v];
+				model.indices.push_back(static_cast<uint32_t>(idx.vertex_index));
+				const float* position = &attrib.vertices[3 * static_cast<size_t>(idx.vertex_index)];
+				triangle[v].position = Vec4f(position[0], position[1], position[2]);
+				if (idx.texcoord_index >= 0)
+				{
+					const float* uv = &attrib.texcoords[2 * static_cast<size_t>(idx.texcoord_index)];
+					triangle[v].uv = TexCoord(uv[0], uv[1]);
+				}
+			}
+			index_offset += fv;
+			model.triangles.push_back(triangle);
+		}
+	}
+
+	model.positions.resize(attrib.vertices.size() / 3);
+	for (size_t i = 0; i < model.positions.size(); i++)
+		model.positions[i] = Vec3f(attrib.vertices[3 * i + 0], attrib.vertices[3 * i + 1], attrib.vertices[3 * i + 2]);
+	return true;
+}
+
+/**
+ * \brief Returns the milliseconds since a point in time.
+ * \param start The point in time.
+ * \return The milliseconds.
+ */
+inline double milliseconds_since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,232 @@
+// The benchmarks load the obj-files themselves, since they do not link the rendering:
+#define TINYOBJLOADER_IMPLEMENTATION
+#define TINYOBJLOADER_USE_MAPBOX_EARCUT
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <list>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+#include "BenchmarkModels.h"
+#include "geometry/HalfEdgeMesh.h"
+#include "geometry/SpatialSort.h"
+
+/* The size of the simulated cache in bytes: */
+#define CACHE_SIZE 32768
+
+/* The size of a simulated cache line in bytes: */
+#define CACHE_LINE_SIZE 64
+
+/* The number of cells per side of the shuffled grid: */
+#define GRID_SIZE 1024
+
+namespace
+{
+	/**
+	 * \brief A fully associative cache with least recently used replacement, which counts the misses of the
+	 * accesses it replays.
+	 */
+	class CacheSimulator
+	{
+	public:
+		/**
+		 * \brief Replays an access to memory.
+		 */
+		void touch(const void* address, size_t bytes)
+		{
+			const uintptr_t first = reinterpret_cast<uintptr_t>(address) / CACHE_LINE_SIZE;
+			const uintptr_t last = (reinterpret_cast<uintptr_t>(address) + bytes - 1) / CACHE_LINE_SIZE;
+			for (uintptr_t line = first; line <= last; line++)
+			{
+				accesses++;
+				const auto found = positions.find(line);
+				if (found != positions.end())
+				{
+					lines.splice(lines.begin(), lines, found->second);
+					continue;
+				}
+				misses++;
+				lines.push_front(line);
+				positions[line] = lines.begin();
+				if (lines.size() > CACHE_SIZE / CACHE_LINE_SIZE)
+				{
+					positions.erase(lines.back());
+					lines.pop_back();
+				}
+			}
+		}
+
+		/**
+		 * \brief Returns the percentage of the accessed lines which were not cached.
+		 */
+		double miss_rate() const
+		{
+			return accesses == 0 ? 0.0 : 100.0 * misses / accesses;
+		}
+
+	private:
+		/**
+		 * \brief The cached lines from the most to the least recently used one.
+		 */
+		std::list<uintptr_t> lines;
+
+		/**
+		 * \brief The position of each cached line in 'lines'.
+		 */
+		std::unordered_map<uintptr_t, std::list<uintptr_t>::iterator> positions;
+
+		/**
+		 * \brief The number of accessed lines.
+		 */
+		size_t accesses = 0;
+
+		/**
+		 * \brief The number of accessed lines which were not cached.
+		 */
+		size_t misses = 0;
+	};
+
+	/**
+	 * \brief Returns a wavy grid of 2 * n^2 triangles whose vertices and triangles are stored in a random order,
+	 * like meshes which were exported without regard to their layout.
+	 */
+	BenchmarkModel shuffled_grid(uint32_t n)
+	{
+		BenchmarkModel model;
+		model.positions.resize(static_cast<size_t>(n + 1) * (n + 1));
+		for (uint32_t y = 0; y <= n; y++)
+		{
+			for (uint32_t x = 0; x <= n; x++)
+				model.positions[y * (n + 1) + x] = Vec3f(static_cast<float>(x) / n, static_cast<float>(y) / n, 0.1f * std::sin(x * 0.05f) * std::cos(y * 0.05f));
+		}
+
+		std::vector<uint32_t> faces;
+		for (uint32_t y = 0; y < n; y++)
+		{
+			for (uint32_t x = 0; x < n; x++)
+			{
+				const uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+				faces.insert(faces.end(), { a, b, d, a, d, c });
+			}
+		}
+
+		// moves each vertex to a random id and the triangles to a random order
+		std::mt19937 random(1);
+		std::vector<uint32_t> vertex_ids(model.positions.size());
+		for (uint32_t i = 0; i < vertex_ids.size(); i++)
+			vertex_ids[i] = i;
+		std::shuffle(vertex_ids.begin(), vertex_ids.end(), random);
+		std::vector<Vec3f> positions(model.positions.size());
+		for (size_t i = 0; i < vertex_ids.size(); i++)
+			positions[vertex_ids[i]] = model.positions[i];
+		model.positions = std::move(positions);
+
+		std::vector<uint32_t> order(faces.size() / 3);
+		for (uint32_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::shuffle(order.begin(), order.end(), random);
+		for (uint32_t face : order)
+		{
+			Triangle triangle;
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const uint32_t vertex = vertex_ids[faces[3 * face + corner]];
+				const Vec3f& p = model.positions[vertex];
+				model.indices.push_back(vertex);
+				triangle[corner].position = Vec4f(p.x, p.y, p.z, 1.f);
+			}
+			model.triangles.push_back(triangle);
+		}
+		return model;
+	}
+
+	/**
+	 * \brief Replays the vertex fetch over the index buffer and a pass over the neighbours of each triangle through
+	 * the simulated cache, and times the neighbour pass.
+	 */
+	void measure(const std::string& label, const BenchmarkModel& model)
+	{
+		const HalfEdgeMesh mesh(model.indices, model.positions);
+
+		CacheSimulator vertex_cache;
+		for (uint32_t vertex : model.indices)
+			vertex_cache.touch(&model.positions[vertex], sizeof(Vec3f));
+
+		CacheSimulator neighbour_cache;
+		for (uint32_t face = 0; face < mesh.face_count(); face++)
+		{
+			neighbour_cache.touch(&model.triangles[face], sizeof(Triangle));
+			for (uint32_t h = HalfEdgeMesh::half_edge(face); h < HalfEdgeMesh::half_edge(face) + 3; h++)
+			{
+				const uint32_t twin = mesh.twin(h);
+				if (twin != HalfEdgeMesh::INVALID)
+					neighbour_cache.touch(&model.triangles[HalfEdgeMesh::face(twin)], sizeof(Triangle));
+			}
+		}
+
+		// the same neighbour pass on the real caches, with a result so it is not optimized away
+		const auto start = std::chrono::steady_clock::now();
+		float sum = 0.f;
+		for (uint32_t face = 0; face < mesh.face_count(); face++)
+		{
+			for (uint32_t h = HalfEdgeMesh::half_edge(face); h < HalfEdgeMesh::half_edge(face) + 3; h++)
+			{
+				const uint32_t twin = mesh.twin(h);
+				if (twin != HalfEdgeMesh::INVALID)
+					sum += model.triangles[HalfEdgeMesh::face(twin)].vertices[0].position.z + mesh.position(mesh.origin(twin)).z;
+			}
+		}
+		const double pass_ms = milliseconds_since(start);
+		volatile float result = sum;
+		(void)result;
+
+		std::cout << std::left << std::setw(42) << label << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(13) << vertex_cache.miss_rate() << "%"
+			<< std::setw(16) << neighbour_cache.miss_rate() << "%"
+			<< std::setw(18) << pass_ms << std::endl;
+	}
+
+	/**
+	 * \brief Measures a model before and after sorting it along the Morton curve.
+	 */
+	void run(const std::string& name, BenchmarkModel model)
+	{
+		measure(name, model);
+		const auto start = std::chrono::steady_clock::now();
+		SpatialSort::sort_triangles(model.triangles, model.indices);
+		SpatialSort::sort_vertices(model.indices, model.positions);
+		const double sort_ms = milliseconds_since(start);
+		std::ostringstream label;
+		label << name << " sorted (" << std::fixed << std::setprecision(1) << sort_ms << " ms)";
+		measure(label.str(), model);
+	}
+}
+
+/**
+ * \brief Compares the cache misses of mesh passes before and after 'SpatialSort' for the given models, or all
+ * bundled models without arguments, and a grid which is stored in a random order.
+ * The misses are counted by replaying the accesses through a simulated cache of the size of a typical L1 data
+ * cache, so they do not depend on the machine.
+ */
+int main(int argc, char** argv)
+{
+	std::vector<std::string> file_names = BENCHMARK_MODELS;
+	if (argc > 1)
+		file_names.assign(argv + 1, argv + argc);
+
+	std::cout << std::left << std::setw(42) << "model" << std::right << std::setw(14) << "vertex miss" << std::setw(17)
+		<< "neighbour miss" << std::setw(18) << "neighbour ms" << "   (" << CACHE_SIZE / 1024 << " KB cache, "
+		<< CACHE_LINE_SIZE << " byte lines)" << std::endl;
+	for (const std::string& file_name : file_names)
+	{
+		BenchmarkModel model;
+		if (!load_benchmark_model(file_name, model) || model.triangles.empty())
+			continue;
+		run(file_name, std::move(model));
+	}
+	run("shuffled grid", shuffled_grid(GRID_SIZE));
+	return EXIT_SUCCESS;
+}
@@ -143,7 +143,7 @@ private:
 	 */
 	Mat4f get_mouse_movement_matrix(void) const
 	{
-		return Mat4f::scale(mouse_zoom) * Mat4f::rotation(mouse_rotation_x, mouse_rotation_y);
+		return Mat4f::transformation(Vec4f(0, 0, 0, 0), mouse_rotation_x, mouse_rotation_y, 0.f, Vec4f(mouse_zoom, mouse_zoom, mouse_zoom, 0));
 	}
 
 	/**
@@ -0,0 +1,103 @@
+#include "AttributeTransfer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "utilities/Parallel.h"
+
+/* The relative slack of the search radius from the closest triangle of the previous point: (rounding of the distances) */
+#define ATTRIBUTE_TRANSFER_SEED_SLACK 1.0001f
+
+const uint32_t AttributeTransfer::COLOR;
+const uint32_t AttributeTransfer::NORMAL;
+const uint32_t AttributeTransfer::UV;
+const uint32_t AttributeTransfer::ALL;
+
+AttributeTransfer::AttributeTransfer(const std::vector<Triangle>& source)
+	: source(source), bvh(source)
+{
+}
+
+void AttributeTransfer::find(const Vec4f* points, size_t count, ClosestPointResult* results, float max_distance) const
+{
+	const ClosestPointQuery query(bvh);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		// the closest triangle of the previous point of this thread
+		uint32_t seed = ClosestPointQuery::NO_TRIANGLE;
+		for (size_t i = begin; i < end; i++)
+		{
+			// the seed triangle bounds the distance, so the traversal skips all nodes which are farther away
+			float radius = max_distance;
+			if (seed != ClosestPointQuery::NO_TRIANGLE)
+			{
+				const Triangle& triangle = source[seed];
+				const Vec3f p(points[i]);
+				const Barycentric barycentric = triangle.closest_barycentric(points[i]);
+				const Vec3f closest = Vec3f(triangle.vertices[0].position) * barycentric.alpha
+					+ Vec3f(triangle.vertices[1].position) * barycentric.beta + Vec3f(triangle.vertices[2].position) * barycentric.gamma;
+				radius = std::min(radius, (closest - p).length() * ATTRIBUTE_TRANSFER_SEED_SLACK + 1e-6f);
+			}
+			if (!query.find(points[i], results[i], radius) && radius < max_distance)
+				query.find(points[i], results[i], max_distance);
+			if (results[i].triangle != ClosestPointQuery::NO_TRIANGLE)
+				seed = results[i].triangle;
+		}
+	}, 256);
+}
+
+Vertex AttributeTransfer::interpolate(const ClosestPointResult& closest) const
+{
+	Vertex vertex = source[closest.triangle].interpolate(closest.barycentric);
+	vertex.position = closest.point;
+	return vertex;
+}
+
+template <typename Vertices>
+size_t AttributeTransfer::transfer(Vertices vertices, size_t count, uint32_t attributes, float max_distance) const
+{
+	std::vector<Vec4f> points(count);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+			points[i] = vertices(i).position;
+	}, 16384);
+	std::vector<ClosestPointResult> results(count);
+	find(points.data(), count, results.data(), max_distance);
+
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			if (results[i].triangle == ClosestPointQuery::NO_TRIANGLE)
+				continue;
+			const Vertex closest = interpolate(results[i]);
+			Vertex& vertex = vertices(i);
+			if (attributes & COLOR)
+				vertex.color = closest.color;
+			if (attributes & NORMAL)
+			{
+				const Vec3f normal(closest.normal);
+				const float length = normal.length();
+				if (length > 0.f)
+					vertex.normal = (normal * (1.f / length)).toVector();
+			}
+			if (attributes & UV)
+				vertex.uv = closest.uv;
+		}
+	}, 16384);
+	return static_cast<size_t>(std::count_if(results.begin(), results.end(), [](const ClosestPointResult& result)
+	{
+		return result.triangle != ClosestPointQuery::NO_TRIANGLE;
+	}));
+}
+
+size_t AttributeTransfer::transfer(std::vector<Vertex>& vertices, uint32_t attributes, float max_distance) const
+{
+	return transfer([&](size_t i) -> Vertex& { return vertices[i]; }, vertices.size(), attributes, max_distance);
+}
+
+size_t AttributeTransfer::transfer(std::vector<Triangle>& triangles, uint32_t attributes, float max_distance) const
+{
+	return transfer([&](size_t i) -> Vertex& { return triangles[i / 3].vertices[i % 3]; }, 3 * triangles.size(), attributes, max_distance);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "geometry/BVH.h"
+#include "geometry/ClosestPointQuery.h"
+#include "primitives/Triangle.h"
+#include "primitives/Vertex.h"
+
+/**
+ * \brief Transfers vertex attributes from a source mesh onto other points, e.g. to bake the colors and normals
+ * of a high resolution mesh onto a simplified one. Each point takes the interpolated attributes of the closest
+ * point on the source mesh.
+ * Neighbouring points usually have the same or a neighbouring closest triangle, so the distance to the closest
+ * triangle of the previous point bounds the search radius of the next one. This works best if the points are
+ * spatially sorted. (see 'SpatialSort')
+ */
+class AttributeTransfer
+{
+public:
+	/**
+	 * \brief Transfers the colors.
+	 */
+	static const uint32_t COLOR = 1;
+
+	/**
+	 * \brief Transfers the normals. (normalized after the interpolation)
+	 */
+	static const uint32_t NORMAL = 2;
+
+	/**
+	 * \brief Transfers the uv coordinates.
+	 */
+	static const uint32_t UV = 4;
+
+	/**
+	 * \brief Transfers all attributes.
+	 */
+	static const uint32_t ALL = COLOR | NORMAL | UV;
+
+	/**
+	 * \brief The constructor. Builds the bounding volume hierarchy of the source.
+	 * \param source The triangles of the source mesh. (they have to outlive the transfer)
+	 */
+	explicit AttributeTransfer(const std::vector<Triangle>& source);
+
+	/**
+	 * \brief Finds the closest points on the source mesh of many points on all threads.
+	 * \param points The points.
+	 * \param count The number of points.
+	 * \param results The closest points.
+	 * \param max_distance The maximum distance to the source mesh.
+	 */
+	void find(const Vec4f* points, size_t count, ClosestPointResult* results,
+		float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * \brief Returns the interpolated attributes of the source mesh at a closest point.
+	 * \param closest The closest point.
+	 * \return The vertex. (with the position of the closest point)
+	 */
+	Vertex interpolate(const ClosestPointResult& closest) const;
+
+	/**
+	 * \brief Replaces attributes of vertices with the ones at their closest points on all threads.
+	 * Vertices which are farther away from the source mesh than the maximum distance are kept.
+	 * \param vertices The vertices.
+	 * \param attributes The attributes. (e.g. 'COLOR' | 'NORMAL')
+	 * \param max_distance The maximum distance to the source mesh.
+	 * \return The number of changed vertices.
+	 */
+	size_t transfer(std::vector<Vertex>& vertices, uint32_t attributes = ALL,
+		float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * \brief Replaces attributes of the corners of triangles with the ones at their closest points on all threads.
+	 * Corners which are farther away from the source mesh than the maximum distance are kept.
+	 * \param triangles The triangles. (e.g. of 'Mesh::get_triangles')
+	 * \param attributes The attributes. (e.g. 'COLOR' | 'NORMAL')
+	 * \param max_distance The maximum distance to the source mesh.
+	 * \return The number of changed corners.
+	 */
+	size_t transfer(std::vector<Triangle>& triangles, uint32_t attributes = ALL,
+		float max_distance = std::numeric_limits<float>::infinity()) const;
+
+private:
+	/**
+	 * \brief Replaces attributes of vertices with the ones at their closest points on all threads.
+	 * \param vertices Returns the vertex with an index.
+	 * \param count The number of vertices.
+	 * \param attributes The attributes.
+	 * \param max_distance The maximum distance to the source mesh.
+	 * \return The number of changed vertices.
+	 */
+	template <typename Vertices>
+	size_t transfer(Vertices vertices, size_t count, uint32_t attributes, float max_distance) const;
+
+	/**
+	 * \brief The triangles of the source mesh.
+	 */
+	const std::vector<Triangle>& source;
+
+	/**
+	 * \brief The bounding volume hierarchy of the source mesh.
+	 */
+	BVH bvh;
+};
@@ -0,0 +1,276 @@
+#include "BVH.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <future>
+#include <limits>
+
+#include "utilities/Parallel.h"
+
+/* The number of bins per axis which are evaluated by the surface area heuristic: */
+#define BVH_BIN_COUNT 16
+
+/* Subtrees with at least this many triangles are built on another thread: */
+#define BVH_PARALLEL_THRESHOLD 4096
+
+namespace
+{
+	/**
+	 * \brief An axis aligned bounding box used during the construction.
+	 */
+	struct Bounds
+	{
+		Vec3f min = Vec3f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+		Vec3f max = Vec3f(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+
+		void grow(Vec3f p)
+		{
+			min = Vec3f::min(min, p);
+			max = Vec3f::max(max, p);
+		}
+
+		void grow(const Bounds& b)
+		{
+			min = Vec3f::min(min, b.min);
+			max = Vec3f::max(max, b.max);
+		}
+
+		float area() const
+		{
+			const Vec3f d = max - min;
+			if (d.x < 0.f) return 0.f;
+			return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+	};
+
+	/**
+	 * \brief Returns the most triangles a subtree at a depth can hold, if all its leaves at the maximum depth are full.
+	 */
+	uint64_t subtree_capacity(int depth)
+	{
+		const int levels = BVH_MAX_DEPTH - 1 - depth;
+		return levels >= 32 ? ~0ull : 0xFFFFull << levels;
+	}
+
+	/**
+	 * \brief A bin of the surface area heuristic.
+	 */
+	struct Bin
+	{
+		Bounds bounds;
+		uint32_t count = 0;
+	};
+}
+
+struct BVH::BuildData
+{
+	std::vector<Bounds> bounds;
+	std::vector<Vec3f> centroids;
+	std::atomic<uint32_t> node_count;
+	unsigned int max_leaf_size;
+	int parallel_depth;
+};
+
+BVH::BVH(const std::vector<Triangle>& triangles, unsigned int max_leaf_size)
+{
+	const uint32_t count = static_cast<uint32_t>(triangles.size());
+	if (count == 0) return;
+
+	BuildData data;
+	data.bounds.resize(count);
+	data.centroids.resize(count);
+	data.node_count = 1;
+	data.max_leaf_size = std::max(1u, std::min(max_leaf_size, 0xFFFFu));
+	data.parallel_depth = 0;
+	for (unsigned int threads = Utilities::thread_count(); threads > 1; threads /= 2)
+		data.parallel_depth++;
+	data.parallel_depth += 2;
+
+	// bounds and centroid of each triangle
+	triangle_ids.resize(count);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			Bounds bounds;
+			for (int v = 0; v < 3; v++)
+				bounds.grow(Vec3f(triangles[i].vertices[v].position));
+			data.bounds[i] = bounds;
+			data.centroids[i] = (bounds.min + bounds.max) * 0.5f;
+			triangle_ids[i] = static_cast<uint32_t>(i);
+		}
+	});
+
+	// a binary tree with n leaves has at most 2n-1 nodes
+	nodes.resize(2 * static_cast<size_t>(count) - 1);
+	build(data, 0, 0, count, 0);
+	nodes.resize(data.node_count);
+
+	// copies the vertices in leaf order
+	vertices.resize(3 * static_cast<size_t>(count));
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			for (int v = 0; v < 3; v++)
+				vertices[3 * i + v] = Vec3f(triangles[triangle_ids[i]].vertices[v].position);
+		}
+	});
+}
+
+bool BVH::empty() const
+{
+	return triangle_ids.empty();
+}
+
+size_t BVH::size() const
+{
+	return triangle_ids.size();
+}
+
+const std::vector<BVHNode>& BVH::get_nodes() const
+{
+	return nodes;
+}
+
+uint32_t BVH::get_triangle_id(uint32_t primitive) const
+{
+	return triangle_ids[primitive];
+}
+
+const Vec3f* BVH::get_vertices(uint32_t primitive) const
+{
+	return &vertices[3 * static_cast<size_t>(primitive)];
+}
+
+void BVH::build(BuildData& data, uint32_t node_index, uint32_t begin, uint32_t end, int depth)
+{
+	const uint32_t count = end - begin;
+	assert(depth < BVH_MAX_DEPTH && count <= subtree_capacity(depth));
+
+	// bounds of the triangles and of their centroids
+	Bounds bounds, centroid_bounds;
+	for (uint32_t i = begin; i < end; i++)
+	{
+		bounds.grow(data.bounds[triangle_ids[i]]);
+		centroid_bounds.grow(data.centroids[triangle_ids[i]]);
+	}
+
+	BVHNode& node = nodes[node_index];
+	for (int i = 0; i < 3; i++)
+	{
+		node.bounds_min[i] = bounds.min[i];
+		node.bounds_max[i] = bounds.max[i];
+	}
+	node.index = begin;
+	node.count = static_cast<uint16_t>(count);
+	node.axis = 0;
+	if (count == 1 || depth + 1 >= BVH_MAX_DEPTH) return;
+
+	// binned surface area heuristic over all three axes
+	float best_cost = std::numeric_limits<float>::max();
+	int best_axis = -1, best_split = 0;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		// extents which overflow or scales which do would turn the bin indices into NaN
+		const float extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+		const float scale = BVH_BIN_COUNT / extent;
+		if (!(extent > 0.f) || !std::isfinite(extent) || !std::isfinite(scale)) continue;
+
+		Bin bins[BVH_BIN_COUNT];
+		for (uint32_t i = begin; i < end; i++)
+		{
+			const uint32_t id = triangle_ids[i];
+			const int b = std::min(static_cast<int>((data.centroids[id][axis] - centroid_bounds.min[axis]) * scale), BVH_BIN_COUNT - 1);
+			bins[b].bounds.grow(data.bounds[id]);
+			bins[b].count++;
+		}
+
+		// sweeps from the right, then evaluates each split from the left
+		float right_cost[BVH_BIN_COUNT];
+		Bounds right;
+		uint32_t right_count = 0;
+		for (int b = BVH_BIN_COUNT - 1; b > 0; b--)
+		{
+			right.grow(bins[b].bounds);
+			right_count += bins[b].count;
+			right_cost[b] = right.area() * right_count;
+		}
+		Bounds left;
+		uint32_t left_count = 0;
+		for (int b = 1; b < BVH_BIN_COUNT; b++)
+		{
+			left.grow(bins[b - 1].bounds);
+			left_count += bins[b - 1].count;
+			const float cost = left.area() * left_count + right_cost[b];
+			if (cost < best_cost)
+			{
+				best_cost = cost;
+				best_axis = axis;
+				best_split = b;
+			}
+		}
+	}
+
+	uint32_t middle;
+	if (best_axis == -1)
+	{
+		// all centroids are equal, so the triangles can only be split by their order
+		if (count <= data.max_leaf_size) return;
+		best_axis = 0;
+		middle = begin + count / 2;
+	}
+	else
+	{
+		// the traversal of an inner node costs as much as one triangle test
+		const float area = bounds.area();
+		const float leaf_cost = static_cast<float>(count);
+		const float split_cost = 1.f + (area > 0.f ? best_cost / area : 0.f);
+		if (count <= data.max_leaf_size && leaf_cost <= split_cost) return;
+
+		const float min = centroid_bounds.min[best_axis];
+		const float scale = BVH_BIN_COUNT / (centroid_bounds.max[best_axis] - min);
+		middle = static_cast<uint32_t>(std::partition(triangle_ids.begin() + begin, triangle_ids.begin() + end,
+			[&](uint32_t id)
+			{
+				const int b = std::min(static_cast<int>((data.centroids[id][best_axis] - min) * scale), BVH_BIN_COUNT - 1);
+				return b < best_split;
+			}) - triangle_ids.begin());
+		if (middle == begin || middle == end)
+			middle = begin + count / 2;
+
+		// a child which could not reach its leaves above the maximum depth is split at the median instead,
+		// which halves the triangles per level until the leaves fit
+		if (std::max(middle - begin, end - middle) > subtree_capacity(depth + 1))
+		{
+			middle = begin + count / 2;
+			std::nth_element(triangle_ids.begin() + begin, triangle_ids.begin() + middle, triangle_ids.begin() + end,
+				[&](uint32_t a, uint32_t b)
+				{
+					return data.centroids[a][best_axis] < data.centroids[b][best_axis];
+				});
+		}
+	}
+
+	const uint32_t children = data.node_count.fetch_add(2);
+	node.index = children;
+	node.count = 0;
+	node.axis = static_cast<uint16_t>(best_axis);
+
+	if (count >= BVH_PARALLEL_THRESHOLD && depth < data.parallel_depth)
+	{
+		std::future<void> left = std::async(std::launch::async, [&]()
+		{
+			build(data, children, begin, middle, depth + 1);
+		});
+		build(data, children + 1, middle, end, depth + 1);
+		left.get();
+	}
+	else
+	{
+		build(data, children, begin, middle, depth + 1);
+		build(data, children + 1, middle, end, depth + 1);
+	}
+}
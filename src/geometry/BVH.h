@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/Vec3f.h"
+#include "primitives/Triangle.h"
+
+/* The maximum depth of a hierarchy, so that queries can use a fixed size stack: */
+#define BVH_MAX_DEPTH 64
+
+/**
+ * \brief A node of the bounding volume hierarchy. (32 bytes)
+ */
+struct BVHNode
+{
+	/**
+	 * \brief The minimum corner of the bounding box.
+	 */
+	float bounds_min[3];
+
+	/**
+	 * \brief The maximum corner of the bounding box.
+	 */
+	float bounds_max[3];
+
+	/**
+	 * \brief The index of the first child (inner node) or of the first primitive (leaf).
+	 * The second child always follows the first one.
+	 */
+	uint32_t index;
+
+	/**
+	 * \brief The number of primitives. (0 for inner nodes)
+	 */
+	uint16_t count;
+
+	/**
+	 * \brief The split axis of an inner node. (0-2)
+	 */
+	uint16_t axis;
+
+	/**
+	 * \brief Whether this node is a leaf.
+	 * \return Is this a leaf.
+	 */
+	bool is_leaf() const
+	{
+		return count != 0;
+	}
+
+	/**
+	 * \brief Returns the squared distance from a point to the bounding box.
+	 * \param p The point.
+	 * \return The squared distance. (0 if the point is inside)
+	 */
+	float squared_distance(Vec3f p) const
+	{
+		float d = 0.f;
+		for (int i = 0; i < 3; i++)
+		{
+			const float v = std::max(std::max(bounds_min[i] - p[i], p[i] - bounds_max[i]), 0.f);
+			d += v * v;
+		}
+		return d;
+	}
+};
+static_assert(sizeof(BVHNode) == 32, "BVHNode should stay 32 bytes.");
+
+/**
+ * \brief A bounding volume hierarchy over a triangle list.
+ * Built with binned SAH. The triangle vertices are copied in leaf order, so queries only touch the hierarchy.
+ */
+class BVH
+{
+public:
+	/**
+	 * \brief The constructor. Builds the hierarchy in parallel.
+	 * \param triangles The triangles. (e.g. of 'Mesh::get_triangles')
+	 * \param max_leaf_size The maximum number of triangles per leaf.
+	 */
+	explicit BVH(const std::vector<Triangle>& triangles, unsigned int max_leaf_size = 4);
+
+	/**
+	 * \brief Whether the hierarchy contains no triangles.
+	 * \return Is the hierarchy empty.
+	 */
+	bool empty() const;
+
+	/**
+	 * \brief Returns the number of triangles.
+	 * \return The number of triangles.
+	 */
+	size_t size() const;
+
+	/**
+	 * \brief Returns the nodes. (The root is the first node)
+	 * \return The nodes.
+	 */
+	const std::vector<BVHNode>& get_nodes() const;
+
+	/**
+	 * \brief Returns the id of a triangle in the original triangle list.
+	 * \param primitive The primitive index. (as referenced by the leaves)
+	 * \return The triangle id.
+	 */
+	uint32_t get_triangle_id(uint32_t primitive) const;
+
+	/**
+	 * \brief Returns the three vertex positions of a primitive.
+	 * \param primitive The primitive index. (as referenced by the leaves)
+	 * \return The vertex positions.
+	 */
+	const Vec3f* get_vertices(uint32_t primitive) const;
+
+private:
+	/**
+	 * \brief The temporary data during the construction.
+	 */
+	struct BuildData;
+
+	/**
+	 * \brief Builds a subtree.
+	 * \param data The construction data.
+	 * \param node The node index.
+	 * \param begin The first primitive.
+	 * \param end The end of the primitives.
+	 * \param depth The depth of the node.
+	 */
+	void build(BuildData& data, uint32_t node, uint32_t begin, uint32_t end, int depth);
+
+	/**
+	 * \brief The nodes.
+	 */
+	std::vector<BVHNode> nodes;
+
+	/**
+	 * \brief The triangle id of each primitive.
+	 */
+	std::vector<uint32_t> triangle_ids;
+
+	/**
+	 * \brief The vertex positions of each primitive. (3 per primitive)
+	 */
+	std::vector<Vec3f> vertices;
+};
@@ -0,0 +1,87 @@
+#include "ClosestPointQuery.h"
+
+#include <cmath>
+
+#include "utilities/Parallel.h"
+
+ClosestPointQuery::ClosestPointQuery(const BVH& bvh)
+	: bvh(bvh)
+{
+}
+
+bool ClosestPointQuery::find(Vec4f point, ClosestPointResult& result, float max_distance) const
+{
+	result.triangle = NO_TRIANGLE;
+	result.distance = std::numeric_limits<float>::infinity();
+	if (bvh.empty()) return false;
+
+	const Vec3f p(point);
+	const std::vector<BVHNode>& nodes = bvh.get_nodes();
+
+	// the search radius shrinks with every closer triangle
+	float best = max_distance < std::numeric_limits<float>::infinity() ? max_distance * max_distance : max_distance;
+	uint32_t best_primitive = NO_TRIANGLE;
+	Barycentric best_barycentric;
+
+	struct Entry
+	{
+		uint32_t node;
+		float distance;
+	};
+	Entry stack[BVH_MAX_DEPTH + 1];
+	int size = 0;
+	stack[size++] = { 0, nodes[0].squared_distance(p) };
+	while (size > 0)
+	{
+		const Entry entry = stack[--size];
+		if (entry.distance > best) continue;
+
+		const BVHNode& node = nodes[entry.node];
+		if (node.is_leaf())
+		{
+			for (uint32_t i = node.index; i < node.index + node.count; i++)
+			{
+				const Vec3f* v = bvh.get_vertices(i);
+				const Barycentric barycentric = Triangle::closest_barycentric(p, v[0], v[1], v[2]);
+				const Vec3f closest = v[0] * barycentric.alpha + v[1] * barycentric.beta + v[2] * barycentric.gamma;
+				const float distance = (closest - p).squaredLength();
+				if (distance <= best)
+				{
+					best = distance;
+					best_primitive = i;
+					best_barycentric = barycentric;
+				}
+			}
+			continue;
+		}
+
+		// visits the nearer child first, so the radius shrinks before the farther one is checked
+		const float left = nodes[node.index].squared_distance(p);
+		const float right = nodes[node.index + 1].squared_distance(p);
+		const bool left_first = left <= right;
+		const Entry near_entry = { left_first ? node.index : node.index + 1, left_first ? left : right };
+		const Entry far_entry = { left_first ? node.index + 1 : node.index, left_first ? right : left };
+		if (far_entry.distance <= best) stack[size++] = far_entry;
+		if (near_entry.distance <= best) stack[size++] = near_entry;
+	}
+
+	if (best_primitive == NO_TRIANGLE) return false;
+
+	const Vec3f* v = bvh.get_vertices(best_primitive);
+	result.triangle = bvh.get_triangle_id(best_primitive);
+	result.barycentric = best_barycentric;
+	result.distance = std::sqrt(best);
+	result.point = (v[0] * best_barycentric.alpha + v[1] * best_barycentric.beta + v[2] * best_barycentric.gamma).toPoint();
+	return true;
+}
+
+void ClosestPointQuery::find(const Vec4f* points, size_t count, ClosestPointResult* results, float max_distance) const
+{
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			find(points[i], results[i], max_distance);
+		}
+	}, 256);
+}
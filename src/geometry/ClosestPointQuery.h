@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "geometry/BVH.h"
+#include "primitives/Barycentric.h"
+
+/**
+ * \brief The closest point on a mesh.
+ */
+struct ClosestPointResult
+{
+	/**
+	 * \brief The id of the closest triangle. ('ClosestPointQuery::NO_TRIANGLE' if none was found)
+	 */
+	uint32_t triangle;
+
+	/**
+	 * \brief The barycentric coordinates of the closest point in the triangle.
+	 */
+	Barycentric barycentric;
+
+	/**
+	 * \brief The distance to the closest point.
+	 */
+	float distance;
+
+	/**
+	 * \brief The closest point.
+	 */
+	Vec4f point;
+};
+
+/**
+ * \brief Finds the closest points on the triangles of a bounding volume hierarchy.
+ */
+class ClosestPointQuery
+{
+public:
+	/**
+	 * \brief The triangle id if no triangle is within the search radius.
+	 */
+	static const uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+	/**
+	 * \brief The constructor.
+	 * \param bvh The bounding volume hierarchy. (Has to outlive the query)
+	 */
+	explicit ClosestPointQuery(const BVH& bvh);
+
+	/**
+	 * \brief Finds the closest point on the mesh.
+	 * \param point The query point.
+	 * \param result The closest point.
+	 * \param max_distance The initial search radius.
+	 * \return Whether a triangle was found within the search radius.
+	 */
+	bool find(Vec4f point, ClosestPointResult& result, float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * \brief Finds the closest points of many query points on all threads.
+	 * \param points The query points.
+	 * \param count The number of query points.
+	 * \param results The closest points.
+	 * \param max_distance The initial search radius.
+	 */
+	void find(const Vec4f* points, size_t count, ClosestPointResult* results, float max_distance = std::numeric_limits<float>::infinity()) const;
+
+private:
+	/**
+	 * \brief The bounding volume hierarchy.
+	 */
+	const BVH& bvh;
+};
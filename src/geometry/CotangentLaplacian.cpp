@@ -0,0 +1,96 @@
+#include "CotangentLaplacian.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "utilities/Parallel.h"
+
+CotangentLaplacian::CotangentLaplacian(const HalfEdgeMesh& mesh)
+{
+	const uint32_t vertex_count = mesh.vertex_count();
+	const uint32_t face_count = mesh.face_count();
+
+	// 12 entries per face, and an empty diagonal entry per vertex so isolated vertices are stored too
+	std::vector<SparseEntry> entries(12 * static_cast<size_t>(face_count) + vertex_count);
+	std::vector<double> face_masses(face_count);
+	Utilities::parallel_for(face_count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t face = begin; face < end; face++)
+		{
+			uint32_t vertices[3];
+			double positions[3][3];
+			for (int corner = 0; corner < 3; corner++)
+			{
+				vertices[corner] = mesh.origin(HalfEdgeMesh::half_edge(static_cast<uint32_t>(face)) + corner);
+				const Vec3f position = mesh.position(vertices[corner]);
+				positions[corner][0] = position.x;
+				positions[corner][1] = position.y;
+				positions[corner][2] = position.z;
+			}
+
+			SparseEntry* face_entries = &entries[12 * face];
+			double double_area = 0.0;
+			for (int corner = 0; corner < 3; corner++)
+			{
+				// the cotangent of the angle at the corner weights the opposite edge
+				const int i = (corner + 1) % 3, j = (corner + 2) % 3;
+				double u[3], v[3];
+				for (int axis = 0; axis < 3; axis++)
+				{
+					u[axis] = positions[i][axis] - positions[corner][axis];
+					v[axis] = positions[j][axis] - positions[corner][axis];
+				}
+				const double cross[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+				const double sine = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+				const double weight = sine > 0.0 ? 0.5 * (u[0] * v[0] + u[1] * v[1] + u[2] * v[2]) / sine : 0.0;
+				double_area = sine;
+
+				face_entries[4 * corner + 0] = { vertices[i], vertices[j], -weight };
+				face_entries[4 * corner + 1] = { vertices[j], vertices[i], -weight };
+				face_entries[4 * corner + 2] = { vertices[i], vertices[i], weight };
+				face_entries[4 * corner + 3] = { vertices[j], vertices[j], weight };
+			}
+			face_masses[face] = double_area / 6.0;
+		}
+	}, 4096);
+	for (uint32_t vertex = 0; vertex < vertex_count; vertex++)
+		entries[12 * static_cast<size_t>(face_count) + vertex] = { vertex, vertex, 0.0 };
+	stiffness = SparseMatrix(vertex_count, vertex_count, entries);
+
+	mass.assign(vertex_count, 0.0);
+	for (uint32_t face = 0; face < face_count; face++)
+	{
+		for (int corner = 0; corner < 3; corner++)
+			mass[mesh.origin(HalfEdgeMesh::half_edge(face) + corner)] += face_masses[face];
+	}
+}
+
+const SparseMatrix& CotangentLaplacian::get_stiffness() const
+{
+	return stiffness;
+}
+
+const std::vector<double>& CotangentLaplacian::get_mass() const
+{
+	return mass;
+}
+
+SparseMatrix CotangentLaplacian::diffusion_matrix(double time) const
+{
+	SparseMatrix matrix = stiffness;
+	matrix.scale(time);
+	matrix.add_to_diagonal(mass);
+	return matrix;
+}
+
+std::vector<double> CotangentLaplacian::diffuse(const ConjugateGradient& diffusion, const std::vector<double>& values) const
+{
+	if (values.size() != mass.size())
+		throw std::invalid_argument("'CotangentLaplacian::diffuse' should only be called with one value per vertex.");
+	std::vector<double> right_side(values.size());
+	for (size_t i = 0; i < values.size(); i++)
+		right_side[i] = mass[i] * values[i];
+	std::vector<double> result = values;
+	diffusion.solve(right_side, result);
+	return result;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "geometry/HalfEdgeMesh.h"
+#include "math/ConjugateGradient.h"
+#include "math/SparseMatrix.h"
+
+/**
+ * \brief The cotangent Laplacian and the lumped mass matrix of a triangle mesh.
+ * The stiffness matrix L is positive semidefinite with L_ij = -(cot alpha_ij + cot beta_ij) / 2 for the angles
+ * opposite of the edge ij and the negative sum of its row on the diagonal. The lumped mass of a vertex is a third
+ * of the area of its faces. Each face writes its entries on its own, so the assembly runs in parallel over the faces.
+ * Implicit smoothing and the heat step of the heat method solve (M + t L) u = M u0, which only needs a
+ * 'ConjugateGradient' of 'diffusion_matrix' once per time step t and then one solve per field.
+ */
+class CotangentLaplacian
+{
+public:
+	/**
+	 * \brief The constructor. Assembles the matrices on all threads.
+	 * \param mesh The mesh.
+	 */
+	explicit CotangentLaplacian(const HalfEdgeMesh& mesh);
+
+	/**
+	 * \brief Returns the stiffness matrix L.
+	 * \return The matrix.
+	 */
+	const SparseMatrix& get_stiffness() const;
+
+	/**
+	 * \brief Returns the diagonal of the lumped mass matrix M.
+	 * \return The masses. (one per vertex)
+	 */
+	const std::vector<double>& get_mass() const;
+
+	/**
+	 * \brief Returns the matrix of an implicit diffusion step.
+	 * \param time The time step.
+	 * \return The matrix M + time * L.
+	 */
+	SparseMatrix diffusion_matrix(double time) const;
+
+	/**
+	 * \brief Diffuses values with an implicit step, e.g. to smooth them or for the heat method.
+	 * \param diffusion The solver of a diffusion matrix. (see 'diffusion_matrix')
+	 * \param values The values. (one per vertex)
+	 * \return The diffused values.
+	 */
+	std::vector<double> diffuse(const ConjugateGradient& diffusion, const std::vector<double>& values) const;
+
+private:
+	/**
+	 * \brief The stiffness matrix.
+	 */
+	SparseMatrix stiffness;
+
+	/**
+	 * \brief The diagonal of the lumped mass matrix.
+	 */
+	std::vector<double> mass;
+};
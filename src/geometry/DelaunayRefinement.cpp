@@ -0,0 +1,462 @@
+#include "DelaunayRefinement.h"
+
+#include <algorithm>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <stdexcept>
+
+/* The largest supported minimum angle in degrees, above it the refinement may not terminate: */
+#define DELAUNAY_REFINEMENT_MAX_ANGLE 33.f
+
+/* Input angles below this are not refined, since the segments would split each other forever: (in degrees) */
+#define DELAUNAY_REFINEMENT_SMALL_ANGLE 60.0
+
+/* The relative tolerance of the distances to a shared input vertex which identifies concentric shell vertices: */
+#define DELAUNAY_REFINEMENT_SHELL_TOLERANCE 0.01
+
+namespace
+{
+	const uint32_t INVALID = DelaunayTriangulation::INVALID;
+
+	/**
+	 * \brief Interpolates the attributes of three vertices at a point, which becomes the position.
+	 */
+	Vertex interpolate(const Vertex& a, const Vertex& b, const Vertex& c, double x, double y)
+	{
+		const double ax = a.position.x, ay = a.position.y;
+		const double bx = b.position.x, by = b.position.y;
+		const double cx = c.position.x, cy = c.position.y;
+		const double det = (by - cy) * (ax - cx) + (cx - bx) * (ay - cy);
+		double wa = 1.0 / 3.0, wb = 1.0 / 3.0;
+		if (det != 0.0)
+		{
+			wa = ((by - cy) * (x - cx) + (cx - bx) * (y - cy)) / det;
+			wb = ((cy - ay) * (x - cx) + (ax - cx) * (y - cy)) / det;
+		}
+		const float fa = static_cast<float>(wa), fb = static_cast<float>(wb), fc = 1.f - fa - fb;
+
+		Vertex vertex = Triangle(a, b, c).interpolate(Barycentric(fa, fb, fc));
+		vertex.position.x = static_cast<float>(x);
+		vertex.position.y = static_cast<float>(y);
+		return vertex;
+	}
+
+	/**
+	 * \brief Interpolates the attributes of two vertices.
+	 */
+	Vertex interpolate(const Vertex& a, const Vertex& b, double t)
+	{
+		const float fb = static_cast<float>(t), fa = 1.f - fb;
+		Vertex vertex = Triangle(a, b, b).interpolate(Barycentric(fa, fb, 0.f));
+		vertex.position.x = static_cast<float>(a.position.x + t * (b.position.x - a.position.x));
+		vertex.position.y = static_cast<float>(a.position.y + t * (b.position.y - a.position.y));
+		return vertex;
+	}
+}
+
+DelaunayRefinement::DelaunayRefinement(const std::vector<std::vector<Vertex>>& outlines, float min_angle,
+	float max_area, uint32_t max_vertices)
+	: input_vertex_count(0), max_area(max_area), max_vertices(max_vertices), classified(false)
+{
+	if (!(min_angle >= 0.f && min_angle <= DELAUNAY_REFINEMENT_MAX_ANGLE))
+		throw std::invalid_argument("'DelaunayRefinement' should only be called with minimum angles between 0-33 degrees.");
+	const double sine = std::sin(min_angle * M_PI / 180.0);
+	ratio_bound = min_angle > 0.f ? 1.0 / (4.0 * sine * sine) : std::numeric_limits<double>::infinity();
+
+	// the outline vertices, duplicated positions are merged
+	for (const std::vector<Vertex>& outline : outlines)
+	{
+		std::vector<uint32_t> ids;
+		ids.reserve(outline.size());
+		for (const Vertex& vertex : outline)
+			ids.push_back(triangulation.insert(vertex));
+
+		for (size_t i = 0; i < ids.size(); i++)
+		{
+			const uint32_t a = ids[i], b = ids[(i + 1) % ids.size()];
+			const uint64_t key = edge_key(a, b);
+			if (a == b || segments.count(key)) continue;
+			segments[key] = static_cast<uint32_t>(segment_vertices.size() / 2);
+			segment_vertices.push_back(a);
+			segment_vertices.push_back(b);
+			segment_queue.push_back(key);
+		}
+	}
+	input_vertex_count = triangulation.vertex_count();
+	vertex_segments.assign(input_vertex_count, INVALID);
+
+	// recovers the segments, then refines the triangles inside
+	while (true)
+	{
+		split_segments();
+		if (!classified)
+		{
+			classify();
+			continue;
+		}
+		if (bad_triangles.empty() || triangulation.vertex_count() >= max_vertices) break;
+		const BadTriangle bad = bad_triangles.front();
+		bad_triangles.pop_front();
+		refine(bad);
+	}
+}
+
+const DelaunayTriangulation& DelaunayRefinement::get_triangulation() const
+{
+	return triangulation;
+}
+
+bool DelaunayRefinement::is_inside(uint32_t triangle) const
+{
+	return triangle < inside.size() && inside[triangle] && triangulation.is_alive(triangle) && !triangulation.is_ghost(triangle);
+}
+
+std::vector<uint32_t> DelaunayRefinement::get_indices() const
+{
+	std::vector<uint32_t> indices;
+	for (uint32_t t = 0; t < triangulation.triangle_slot_count(); t++)
+	{
+		if (!is_inside(t)) continue;
+		for (int i = 0; i < 3; i++)
+			indices.push_back(triangulation.triangle_vertex(t, i));
+	}
+	return indices;
+}
+
+std::vector<Triangle> DelaunayRefinement::get_triangles() const
+{
+	const std::vector<uint32_t> indices = get_indices();
+	const std::vector<Vertex>& vertices = triangulation.get_vertices();
+	std::vector<Triangle> triangles(indices.size() / 3);
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		Triangle& triangle = triangles[i];
+		for (int v = 0; v < 3; v++)
+			triangle[v] = vertices[indices[3 * i + v]];
+
+		// flat normals like the loaded meshes
+		const Vec4f normal = (triangle[1].position - triangle[0].position).cross(triangle[2].position - triangle[0].position).normalized();
+		for (int v = 0; v < 3; v++)
+			triangle[v].normal = normal;
+	}
+	return triangles;
+}
+
+uint64_t DelaunayRefinement::edge_key(uint32_t a, uint32_t b)
+{
+	return static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+}
+
+void DelaunayRefinement::split_segments()
+{
+	while (!segment_queue.empty())
+	{
+		const uint64_t key = segment_queue.back();
+		segment_queue.pop_back();
+		if (segments.count(key) && needs_split(static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key)))
+			split_segment(key);
+	}
+}
+
+bool DelaunayRefinement::needs_split(uint32_t a, uint32_t b) const
+{
+	const std::vector<Vertex>& vertices = triangulation.get_vertices();
+	const double ax = vertices[a].position.x, ay = vertices[a].position.y;
+	const double bx = vertices[b].position.x, by = vertices[b].position.y;
+
+	// the midpoint is exact, so it lies on the edge if the edge exists
+	const uint32_t triangle = triangulation.locate(0.5 * (ax + bx), 0.5 * (ay + by));
+	if (triangle == INVALID) return false;
+
+	const auto encroaches = [&](uint32_t vertex)
+	{
+		if (vertex == INVALID) return false;
+		const double px = vertices[vertex].position.x, py = vertices[vertex].position.y;
+		return (ax - px) * (bx - px) + (ay - py) * (by - py) < 0.0;
+	};
+
+	for (int i = 0; i < 3; i++)
+	{
+		const uint32_t p = triangulation.triangle_vertex(triangle, (i + 1) % 3);
+		const uint32_t q = triangulation.triangle_vertex(triangle, (i + 2) % 3);
+		if (!((p == a && q == b) || (p == b && q == a))) continue;
+
+		// in a Delaunay triangulation only the two opposite vertices can be closest to the segment
+		if (encroaches(triangulation.triangle_vertex(triangle, i))) return true;
+		const uint32_t neighbor = triangulation.triangle_neighbor(triangle, i);
+		for (int k = 0; k < 3; k++)
+		{
+			const uint32_t vertex = triangulation.triangle_vertex(neighbor, k);
+			if (vertex != a && vertex != b && encroaches(vertex)) return true;
+		}
+		return false;
+	}
+	return true;
+}
+
+bool DelaunayRefinement::split_segment(uint64_t key)
+{
+	const auto found = segments.find(key);
+	if (found == segments.end()) return false;
+	const uint32_t segment = found->second;
+	const uint32_t a = static_cast<uint32_t>(key >> 32), b = static_cast<uint32_t>(key);
+
+	// copies, since the insertion may move the vertices
+	const Vertex start = triangulation.get_vertices()[a], end = triangulation.get_vertices()[b];
+	const double ax = start.position.x, ay = start.position.y;
+	const double bx = end.position.x, by = end.position.y;
+
+	double t = 0.5;
+	const bool a_input = a < input_vertex_count, b_input = b < input_vertex_count;
+	if (a_input != b_input)
+	{
+		const double length = std::sqrt((bx - ax) * (bx - ax) + (by - ay) * (by - ay));
+		const double shell = std::exp2(std::round(std::log2(0.5 * length))) / length;
+		t = a_input ? shell : 1.0 - shell;
+	}
+	const Vertex vertex = interpolate(start, end, t);
+
+	triangulation.find_cavity(vertex.position.x, vertex.position.y, cavity);
+	segments.erase(found);
+	const uint32_t middle = insert_vertex(vertex, segment);
+	if (middle == INVALID)
+	{
+		// the segment is too short to be split in float precision
+		segments[key] = segment;
+		return false;
+	}
+
+	const uint64_t first = edge_key(a, middle), second = edge_key(middle, b);
+	segments[first] = segment;
+	segments[second] = segment;
+	segment_queue.push_back(first);
+	segment_queue.push_back(second);
+	return true;
+}
+
+uint32_t DelaunayRefinement::insert_vertex(const Vertex& vertex, uint32_t segment)
+{
+	// the segments on the cavity may be destroyed or encroached by the new vertex
+	const size_t queued = segment_queue.size();
+	for (uint32_t triangle : cavity)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			const uint32_t p = triangulation.triangle_vertex(triangle, i), q = triangulation.triangle_vertex(triangle, (i + 1) % 3);
+			if (p != INVALID && q != INVALID && segments.count(edge_key(p, q)))
+				segment_queue.push_back(edge_key(p, q));
+		}
+	}
+
+	const uint32_t count = triangulation.vertex_count();
+	const uint32_t id = triangulation.insert(vertex);
+	if (id < count) return INVALID;
+	vertex_segments.push_back(segment);
+
+	// the kept segments are the outer edges of the new triangles, a destroyed one makes the inside flags unreliable
+	const std::vector<uint32_t>& created = triangulation.get_new_triangles();
+	for (size_t i = queued; i < segment_queue.size() && classified; i++)
+	{
+		const auto kept = [&](uint32_t triangle)
+		{
+			return edge_key(triangulation.triangle_vertex(triangle, 0), triangulation.triangle_vertex(triangle, 1)) == segment_queue[i];
+		};
+		if (std::none_of(created.begin(), created.end(), kept))
+			classified = false;
+	}
+
+	// a new triangle lies on the same side as the triangle behind its outer edge, unless that edge is a segment
+	inside.resize(triangulation.triangle_slot_count(), 0);
+	for (uint32_t triangle : created)
+	{
+		if (triangulation.is_ghost(triangle))
+		{
+			inside[triangle] = 0;
+			continue;
+		}
+		const uint32_t outside = triangulation.triangle_neighbor(triangle, 2);
+		const bool crossing = segments.count(edge_key(triangulation.triangle_vertex(triangle, 0), triangulation.triangle_vertex(triangle, 1))) != 0;
+		inside[triangle] = inside[outside] ^ static_cast<uint8_t>(crossing);
+		if (classified) queue_if_bad(triangle);
+	}
+	return id;
+}
+
+void DelaunayRefinement::classify()
+{
+	const uint32_t slots = triangulation.triangle_slot_count();
+	inside.assign(slots, 0);
+	std::vector<uint8_t> visited(slots, 0);
+	std::vector<uint32_t> stack;
+	for (uint32_t t = 0; t < slots; t++)
+	{
+		if (triangulation.is_alive(t) && triangulation.is_ghost(t))
+		{
+			visited[t] = 1;
+			stack.push_back(t);
+		}
+	}
+
+	// even-odd rule: every crossed segment flips between outside and inside
+	while (!stack.empty())
+	{
+		const uint32_t triangle = stack.back();
+		stack.pop_back();
+		for (int i = 0; i < 3; i++)
+		{
+			const uint32_t neighbor = triangulation.triangle_neighbor(triangle, i);
+			if (visited[neighbor]) continue;
+			const uint32_t p = triangulation.triangle_vertex(triangle, (i + 1) % 3), q = triangulation.triangle_vertex(triangle, (i + 2) % 3);
+			const bool crossing = p != INVALID && q != INVALID && segments.count(edge_key(p, q));
+			inside[neighbor] = inside[triangle] ^ static_cast<uint8_t>(crossing);
+			visited[neighbor] = 1;
+			stack.push_back(neighbor);
+		}
+	}
+
+	// the segments are checked again, since a destroyed segment may have left others encroached
+	classified = true;
+	bad_triangles.clear();
+	for (uint32_t t = 0; t < slots; t++)
+	{
+		if (triangulation.is_alive(t))
+			queue_if_bad(t);
+	}
+	for (const auto& segment : segments)
+		segment_queue.push_back(segment.first);
+}
+
+void DelaunayRefinement::queue_if_bad(uint32_t triangle)
+{
+	if (!inside[triangle] || triangulation.is_ghost(triangle)) return;
+
+	const std::vector<Vertex>& vertices = triangulation.get_vertices();
+	BadTriangle bad;
+	bad.triangle = triangle;
+	double x[3], y[3];
+	for (int i = 0; i < 3; i++)
+	{
+		bad.vertices[i] = triangulation.triangle_vertex(triangle, i);
+		x[i] = vertices[bad.vertices[i]].position.x;
+		y[i] = vertices[bad.vertices[i]].position.y;
+	}
+
+	const double cross = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+	if (cross <= 0.0) return;
+	double lengths[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const double dx = x[(i + 2) % 3] - x[(i + 1) % 3], dy = y[(i + 2) % 3] - y[(i + 1) % 3];
+		lengths[i] = dx * dx + dy * dy;
+	}
+	const double shortest = std::min(lengths[0], std::min(lengths[1], lengths[2]));
+
+	// circumradius^2 = l0 * l1 * l2 / (4 cross^2) and sin(min angle) = shortest / (2 circumradius)
+	const bool too_large = 0.5 * cross > max_area;
+	const bool too_sharp = lengths[0] * lengths[1] * lengths[2] > ratio_bound * 4.0 * cross * cross * shortest;
+	if (too_large || (too_sharp && !in_small_input_angle(triangle)))
+		bad_triangles.push_back(bad);
+}
+
+bool DelaunayRefinement::in_small_input_angle(uint32_t triangle) const
+{
+	const std::vector<Vertex>& vertices = triangulation.get_vertices();
+	const auto squared_length = [&](uint32_t a, uint32_t b)
+	{
+		const double dx = vertices[a].position.x - vertices[b].position.x, dy = vertices[a].position.y - vertices[b].position.y;
+		return dx * dx + dy * dy;
+	};
+
+	// the shortest edge
+	uint32_t p = INVALID, q = INVALID;
+	double shortest = std::numeric_limits<double>::infinity();
+	for (int i = 0; i < 3; i++)
+	{
+		const uint32_t a = triangulation.triangle_vertex(triangle, i), b = triangulation.triangle_vertex(triangle, (i + 1) % 3);
+		const double length = squared_length(a, b);
+		if (length < shortest)
+		{
+			shortest = length;
+			p = a;
+			q = b;
+		}
+	}
+
+	// both vertices on different input segments which share an input vertex
+	const uint32_t p_segment = vertex_segments[p], q_segment = vertex_segments[q];
+	if (p_segment == INVALID || q_segment == INVALID || p_segment == q_segment) return false;
+	uint32_t apex = INVALID;
+	for (int i = 0; i < 2; i++)
+	{
+		for (int k = 0; k < 2; k++)
+		{
+			if (segment_vertices[2 * p_segment + i] == segment_vertices[2 * q_segment + k])
+				apex = segment_vertices[2 * p_segment + i];
+		}
+	}
+	if (apex == INVALID) return false;
+
+	// on the same concentric shell around a small angle
+	const double p_distance = std::sqrt(squared_length(apex, p)), q_distance = std::sqrt(squared_length(apex, q));
+	if (std::abs(p_distance - q_distance) > DELAUNAY_REFINEMENT_SHELL_TOLERANCE * std::max(p_distance, q_distance)) return false;
+	const double dot = (vertices[p].position.x - vertices[apex].position.x) * (vertices[q].position.x - vertices[apex].position.x)
+		+ (vertices[p].position.y - vertices[apex].position.y) * (vertices[q].position.y - vertices[apex].position.y);
+	return dot > std::cos(DELAUNAY_REFINEMENT_SMALL_ANGLE * M_PI / 180.0) * p_distance * q_distance;
+}
+
+void DelaunayRefinement::refine(const BadTriangle& bad)
+{
+	const uint32_t triangle = bad.triangle;
+	if (!triangulation.is_alive(triangle) || !inside[triangle]) return;
+	for (int i = 0; i < 3; i++)
+	{
+		if (triangulation.triangle_vertex(triangle, i) != bad.vertices[i]) return;
+	}
+
+	// the circumcenter, relative to the first vertex for precision
+	const std::vector<Vertex>& vertices = triangulation.get_vertices();
+	const double ax = vertices[bad.vertices[0]].position.x, ay = vertices[bad.vertices[0]].position.y;
+	const double bx = vertices[bad.vertices[1]].position.x - ax, by = vertices[bad.vertices[1]].position.y - ay;
+	const double cx = vertices[bad.vertices[2]].position.x - ax, cy = vertices[bad.vertices[2]].position.y - ay;
+	const double det = 2.0 * (bx * cy - by * cx);
+	if (det == 0.0) return;
+	const double b_length = bx * bx + by * by, c_length = cx * cx + cy * cy;
+	const double x = static_cast<float>(ax + (cy * b_length - by * c_length) / det);
+	const double y = static_cast<float>(ay + (bx * c_length - cx * b_length) / det);
+
+	// a circumcenter inside the diametral circle of a segment splits the segment instead
+	triangulation.find_cavity(x, y, cavity, triangle);
+	if (cavity.empty()) return;
+	std::vector<uint64_t> encroached;
+	for (uint32_t t : cavity)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			const uint32_t p = triangulation.triangle_vertex(t, i), q = triangulation.triangle_vertex(t, (i + 1) % 3);
+			if (p == INVALID || q == INVALID) continue;
+			const uint64_t key = edge_key(p, q);
+			if (!segments.count(key) || std::find(encroached.begin(), encroached.end(), key) != encroached.end()) continue;
+			const double px = vertices[p].position.x, py = vertices[p].position.y;
+			const double qx = vertices[q].position.x, qy = vertices[q].position.y;
+			if ((px - x) * (qx - x) + (py - y) * (qy - y) < 0.0)
+				encroached.push_back(key);
+		}
+	}
+	if (!encroached.empty())
+	{
+		bool split = false;
+		for (uint64_t key : encroached)
+			split |= split_segment(key);
+
+		// tries again once the segments are split, if the triangle still exists
+		if (split) bad_triangles.push_back(bad);
+		return;
+	}
+
+	// the attributes are interpolated in the triangle which contains the circumcenter
+	uint32_t located = triangulation.locate(x, y, triangle);
+	if (located == INVALID || triangulation.is_ghost(located)) located = triangle;
+	const Vertex vertex = interpolate(vertices[triangulation.triangle_vertex(located, 0)],
+		vertices[triangulation.triangle_vertex(located, 1)], vertices[triangulation.triangle_vertex(located, 2)], x, y);
+	insert_vertex(vertex, INVALID);
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "DelaunayTriangulation.h"
+#include "primitives/Triangle.h"
+#include "primitives/Vertex.h"
+
+/**
+ * \brief A quality triangle mesh of the area enclosed by polygon outlines. (Ruppert's refinement)
+ * The outlines are split until every segment is an edge of the Delaunay triangulation, then the circumcenters of
+ * triangles with a too small angle or a too large area are inserted. Circumcenters which would encroach a segment
+ * split the segment instead, so the outlines are always kept. The triangulation is conforming: segments are chains
+ * of Delaunay edges, which is why no constrained edges are needed.
+ */
+class DelaunayRefinement
+{
+public:
+	/**
+	 * \brief The constructor. Meshes the area inside an odd number of outlines, so holes are given as further outlines.
+	 * \param outlines The closed outlines. (the last vertex connects to the first, only x and y are used)
+	 * \param min_angle The minimum angle of the triangles in degrees. (0-33, inside the outlines)
+	 * \param max_area The maximum area of the triangles.
+	 * \param max_vertices The number of vertices after which the refinement stops.
+	 */
+	explicit DelaunayRefinement(const std::vector<std::vector<Vertex>>& outlines, float min_angle = 20.f,
+		float max_area = std::numeric_limits<float>::infinity(), uint32_t max_vertices = 1u << 24);
+
+	/**
+	 * \brief Returns the underlying triangulation, which also covers the convex hull outside the outlines.
+	 * \return The triangulation.
+	 */
+	const DelaunayTriangulation& get_triangulation() const;
+
+	/**
+	 * \brief Whether a triangle of the triangulation lies inside the outlines.
+	 * \param triangle The triangle.
+	 * \return Is the triangle inside.
+	 */
+	bool is_inside(uint32_t triangle) const;
+
+	/**
+	 * \brief Returns the vertex ids of the triangles inside the outlines. (3 per triangle, counterclockwise)
+	 * \return The vertex ids.
+	 */
+	std::vector<uint32_t> get_indices() const;
+
+	/**
+	 * \brief Returns the triangles inside the outlines, e.g. to upload them into a 'Mesh'.
+	 * \return The triangles.
+	 */
+	std::vector<Triangle> get_triangles() const;
+
+private:
+	/**
+	 * \brief A queued triangle with the vertices it had, since the slot may be reused before it is processed.
+	 */
+	struct BadTriangle
+	{
+		uint32_t triangle;
+		uint32_t vertices[3];
+	};
+
+	/**
+	 * \brief Returns the key of an undirected edge.
+	 * \param a The first vertex.
+	 * \param b The second vertex.
+	 * \return The key.
+	 */
+	static uint64_t edge_key(uint32_t a, uint32_t b);
+
+	/**
+	 * \brief Splits the queued segments which are missing in the triangulation or encroached.
+	 */
+	void split_segments();
+
+	/**
+	 * \brief Whether a segment is not an edge of the triangulation or a vertex lies inside its diametral circle.
+	 * \param a The first vertex.
+	 * \param b The second vertex.
+	 * \return Does the segment have to be split.
+	 */
+	bool needs_split(uint32_t a, uint32_t b) const;
+
+	/**
+	 * \brief Splits a segment at its midpoint or, next to an input vertex, at a power of two distance from it.
+	 * (concentric shells, which stop segments sharing a vertex from splitting each other forever)
+	 * \param key The key of the segment.
+	 * \return Whether the segment was split.
+	 */
+	bool split_segment(uint64_t key);
+
+	/**
+	 * \brief Inserts a vertex whose cavity is in 'cavity' and updates the segments and the inside flags.
+	 * \param vertex The vertex.
+	 * \param segment The input segment the vertex lies on. ('DelaunayTriangulation::INVALID' if none)
+	 * \return The id of the vertex. ('DelaunayTriangulation::INVALID' if the position was already used)
+	 */
+	uint32_t insert_vertex(const Vertex& vertex, uint32_t segment);
+
+	/**
+	 * \brief Marks the triangles inside the outlines by flood filling from the ghost triangles.
+	 * Queues the bad triangles and all segments to be checked again.
+	 */
+	void classify();
+
+	/**
+	 * \brief Queues a triangle if it is inside and has a too small angle or a too large area.
+	 * \param triangle The triangle.
+	 */
+	void queue_if_bad(uint32_t triangle);
+
+	/**
+	 * \brief Whether the shortest edge of a triangle lies between two segments with a small angle at their shared
+	 * input vertex. Such triangles can never be improved and are kept.
+	 * \param triangle The triangle.
+	 * \return Is the triangle in a small input angle.
+	 */
+	bool in_small_input_angle(uint32_t triangle) const;
+
+	/**
+	 * \brief Inserts the circumcenter of a bad triangle or splits the segments it encroaches.
+	 * \param bad The triangle.
+	 */
+	void refine(const BadTriangle& bad);
+
+	/**
+	 * \brief The triangulation.
+	 */
+	DelaunayTriangulation triangulation;
+
+	/**
+	 * \brief The current segments by their edge key, with the input segment they are part of.
+	 */
+	std::unordered_map<uint64_t, uint32_t> segments;
+
+	/**
+	 * \brief The input vertices of the input segments. (2 per segment)
+	 */
+	std::vector<uint32_t> segment_vertices;
+
+	/**
+	 * \brief The input segment each vertex lies on. ('DelaunayTriangulation::INVALID' for input vertices and circumcenters)
+	 */
+	std::vector<uint32_t> vertex_segments;
+
+	/**
+	 * \brief Whether each triangle slot lies inside the outlines.
+	 */
+	std::vector<uint8_t> inside;
+
+	/**
+	 * \brief The segments which may have to be split.
+	 */
+	std::vector<uint64_t> segment_queue;
+
+	/**
+	 * \brief The triangles which may have to be refined.
+	 */
+	std::deque<BadTriangle> bad_triangles;
+
+	/**
+	 * \brief Scratch buffer of the cavity of the next vertex.
+	 */
+	std::vector<uint32_t> cavity;
+
+	/**
+	 * \brief The number of input vertices.
+	 */
+	uint32_t input_vertex_count;
+
+	/**
+	 * \brief 1 / (4 sin^2(min_angle)), the bound of the squared circumradius to shortest edge ratio.
+	 */
+	double ratio_bound;
+
+	/**
+	 * \brief The maximum area of the triangles.
+	 */
+	double max_area;
+
+	/**
+	 * \brief The number of vertices after which the refinement stops.
+	 */
+	uint32_t max_vertices;
+
+	/**
+	 * \brief Whether the inside flags are valid and bad triangles are queued. (false after a segment was destroyed)
+	 */
+	bool classified;
+};
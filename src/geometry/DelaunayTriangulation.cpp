@@ -0,0 +1,437 @@
+#include "DelaunayTriangulation.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "math/Morton.h"
+#include "math/Predicates.h"
+#include "utilities/RadixSort.h"
+#include "utilities/Random.h"
+
+/* The approximate number of vertices in the first round of the insertion order: */
+#define DELAUNAY_BRIO_MIN_ROUND 64
+
+/* The number of bits per axis of the Morton codes which order each round: (the round uses the remaining upper bits) */
+#define DELAUNAY_MORTON_BITS 13
+
+namespace
+{
+	/**
+	 * \brief The vertex id which marks free triangle slots.
+	 */
+	const uint32_t DELETED = 0xFFFFFFFE;
+
+	/**
+	 * \brief Returns a biased randomized insertion order. (Amenta, Choi, Rote)
+	 * Each vertex is put into a random round, where the last round gets half of the vertices, the one before
+	 * a quarter and so on. Each round is sorted along the Morton curve. So the insertion stays random enough
+	 * for small expected cavities, while consecutive vertices are close to each other for short walks.
+	 * \param coordinates The coordinates. (x, y per vertex)
+	 * \param count The number of vertices.
+	 * \return The vertex ids in insertion order.
+	 */
+	std::vector<uint32_t> brio_order(const std::vector<double>& coordinates, uint32_t count)
+	{
+		double min_x = std::numeric_limits<double>::max(), min_y = std::numeric_limits<double>::max();
+		double max_x = -std::numeric_limits<double>::max(), max_y = -std::numeric_limits<double>::max();
+		for (uint32_t i = 0; i < count; i++)
+		{
+			min_x = std::min(min_x, coordinates[2 * i]);
+			max_x = std::max(max_x, coordinates[2 * i]);
+			min_y = std::min(min_y, coordinates[2 * i + 1]);
+			max_y = std::max(max_y, coordinates[2 * i + 1]);
+		}
+		const float cells = static_cast<float>((1 << DELAUNAY_MORTON_BITS) - 1);
+		const float scale_x = max_x > min_x ? static_cast<float>(cells / (max_x - min_x)) : 0.f;
+		const float scale_y = max_y > min_y ? static_cast<float>(cells / (max_y - min_y)) : 0.f;
+
+		// the first round has at most about DELAUNAY_BRIO_MIN_ROUND vertices
+		uint32_t rounds = 0;
+		while ((static_cast<uint64_t>(DELAUNAY_BRIO_MIN_ROUND) << rounds) < count) rounds++;
+
+		// the round and the Morton code in the upper and the vertex id in the lower 32 bits
+		std::vector<uint64_t> keys(count);
+		for (uint32_t vertex = 0; vertex < count; vertex++)
+		{
+			// the number of trailing zeros of a random number is 0 for half of the vertices, 1 for a quarter, ...
+			uint64_t random = Utilities::mix_bits(vertex) | (1ull << 63);
+			uint32_t zeros = 0;
+			for (; (random & 1) == 0; random >>= 1) zeros++;
+			const uint64_t round = rounds - std::min(zeros, rounds);
+
+			const uint64_t code = Morton::encode(
+				Morton::quantize(static_cast<float>(coordinates[2 * vertex]), static_cast<float>(min_x), scale_x, DELAUNAY_MORTON_BITS),
+				Morton::quantize(static_cast<float>(coordinates[2 * vertex + 1]), static_cast<float>(min_y), scale_y, DELAUNAY_MORTON_BITS));
+			keys[vertex] = (round << (2 * DELAUNAY_MORTON_BITS) | code) << 32 | vertex;
+		}
+		Utilities::radix_sort(keys, 32, 64);
+
+		std::vector<uint32_t> order(count);
+		for (uint32_t i = 0; i < count; i++)
+			order[i] = static_cast<uint32_t>(keys[i] & 0xFFFFFFFFull);
+		return order;
+	}
+}
+
+const uint32_t DelaunayTriangulation::INVALID;
+
+DelaunayTriangulation::DelaunayTriangulation()
+	: last_triangle(INVALID), insertion(0), first_vertex_triangles(1, INVALID)
+{
+}
+
+DelaunayTriangulation::DelaunayTriangulation(const std::vector<Vertex>& vertices)
+	: vertices(vertices), last_triangle(INVALID), insertion(0)
+{
+	if (vertices.size() >= DELETED)
+		throw std::invalid_argument("'DelaunayTriangulation' only supports 32 bit vertex ids.");
+
+	const uint32_t count = static_cast<uint32_t>(vertices.size());
+	coordinates.resize(2 * static_cast<size_t>(count));
+	for (uint32_t i = 0; i < count; i++)
+	{
+		coordinates[2 * i] = vertices[i].position.x;
+		coordinates[2 * i + 1] = vertices[i].position.y;
+	}
+	first_vertex_triangles.assign(count + 1, INVALID);
+
+	// about 2 triangles per vertex
+	const size_t triangles = 2 * static_cast<size_t>(count) + 16;
+	triangle_slots.reserve(triangles);
+
+	for (uint32_t vertex : brio_order(coordinates, count))
+		insert_vertex(vertex);
+}
+
+uint32_t DelaunayTriangulation::insert(const Vertex& vertex)
+{
+	if (vertices.size() + 1 >= DELETED)
+		throw std::invalid_argument("'DelaunayTriangulation' only supports 32 bit vertex ids.");
+
+	const uint32_t id = static_cast<uint32_t>(vertices.size());
+	vertices.push_back(vertex);
+	coordinates.push_back(vertex.position.x);
+	coordinates.push_back(vertex.position.y);
+	first_vertex_triangles.push_back(INVALID);
+
+	const uint32_t result = insert_vertex(id);
+	if (result != id)
+	{
+		// the position is already used
+		vertices.pop_back();
+		coordinates.resize(coordinates.size() - 2);
+		first_vertex_triangles.pop_back();
+	}
+	return result;
+}
+
+uint32_t DelaunayTriangulation::vertex_count() const
+{
+	return static_cast<uint32_t>(vertices.size());
+}
+
+const std::vector<Vertex>& DelaunayTriangulation::get_vertices() const
+{
+	return vertices;
+}
+
+std::vector<uint32_t> DelaunayTriangulation::get_indices() const
+{
+	std::vector<uint32_t> indices;
+	indices.reserve(3 * triangle_slots.size());
+	for (uint32_t t = 0; t < triangle_slot_count(); t++)
+	{
+		if (!is_alive(t) || is_ghost(t)) continue;
+		indices.insert(indices.end(), triangle_slots[t].vertices, triangle_slots[t].vertices + 3);
+	}
+	return indices;
+}
+
+std::vector<Triangle> DelaunayTriangulation::get_triangles() const
+{
+	const std::vector<uint32_t> indices = get_indices();
+	std::vector<Triangle> triangles(indices.size() / 3);
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		Triangle& triangle = triangles[i];
+		for (int v = 0; v < 3; v++)
+			triangle[v] = vertices[indices[3 * i + v]];
+
+		// flat normals like the loaded meshes
+		const Vec4f normal = (triangle[1].position - triangle[0].position).cross(triangle[2].position - triangle[0].position).normalized();
+		for (int v = 0; v < 3; v++)
+			triangle[v].normal = normal;
+	}
+	return triangles;
+}
+
+uint32_t DelaunayTriangulation::triangle_slot_count() const
+{
+	return static_cast<uint32_t>(triangle_slots.size());
+}
+
+bool DelaunayTriangulation::is_alive(uint32_t triangle) const
+{
+	return triangle_slots[triangle].vertices[0] != DELETED;
+}
+
+bool DelaunayTriangulation::is_ghost(uint32_t triangle) const
+{
+	const uint32_t* v = triangle_slots[triangle].vertices;
+	return v[0] == INVALID || v[1] == INVALID || v[2] == INVALID;
+}
+
+uint32_t DelaunayTriangulation::locate(double x, double y, uint32_t start) const
+{
+	if (last_triangle == INVALID) return INVALID;
+
+	// visibility walk, which always terminates in a Delaunay triangulation
+	uint32_t triangle = start == INVALID || !is_alive(start) || is_ghost(start) ? last_triangle : start;
+	uint32_t previous = INVALID;
+	for (;;)
+	{
+		const uint32_t* v = triangle_slots[triangle].vertices;
+		const uint32_t* n = triangle_slots[triangle].neighbors;
+		uint32_t next = INVALID;
+		for (int i = 0; i < 3; i++)
+		{
+			// the point lies on the inner side of the edge which was crossed
+			if (n[i] == previous) continue;
+			const double* a = &coordinates[2 * static_cast<size_t>(v[(i + 1) % 3])];
+			const double* b = &coordinates[2 * static_cast<size_t>(v[(i + 2) % 3])];
+			if (Predicates::orient2d(a[0], a[1], b[0], b[1], x, y) < 0.0)
+			{
+				next = n[i];
+				break;
+			}
+		}
+		if (next == INVALID) return triangle;
+
+		previous = triangle;
+		triangle = next;
+
+		// the point lies outside of the hull
+		if (is_ghost(triangle)) return triangle;
+	}
+}
+
+void DelaunayTriangulation::find_cavity(double x, double y, std::vector<uint32_t>& triangles, uint32_t start) const
+{
+	triangles.clear();
+	const uint32_t first = locate(x, y, start);
+	if (first == INVALID || !in_conflict(first, x, y)) return;
+
+	// the cavity is connected, it usually has only a few triangles
+	triangles.push_back(first);
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			const uint32_t neighbor = triangle_slots[triangles[i]].neighbors[k];
+			if (std::find(triangles.begin(), triangles.end(), neighbor) == triangles.end() && in_conflict(neighbor, x, y))
+				triangles.push_back(neighbor);
+		}
+	}
+}
+
+const std::vector<uint32_t>& DelaunayTriangulation::get_new_triangles() const
+{
+	return new_triangles;
+}
+
+uint32_t DelaunayTriangulation::insert_vertex(uint32_t vertex)
+{
+	const double x = coordinates[2 * static_cast<size_t>(vertex)], y = coordinates[2 * static_cast<size_t>(vertex) + 1];
+	const auto same_position = [&](uint32_t other)
+	{
+		return coordinates[2 * static_cast<size_t>(other)] == x && coordinates[2 * static_cast<size_t>(other) + 1] == y;
+	};
+
+	// collects vertices until the first three are not collinear
+	if (last_triangle == INVALID)
+	{
+		if (!pending_vertices.empty() && same_position(pending_vertices[0])) return pending_vertices[0];
+		if (pending_vertices.size() > 1 && same_position(pending_vertices[1])) return pending_vertices[1];
+		if (pending_vertices.size() < 2)
+		{
+			pending_vertices.push_back(vertex);
+			return vertex;
+		}
+
+		const uint32_t a = pending_vertices[0], b = pending_vertices[1];
+		const double orientation = Predicates::orient2d(coordinates[2 * a], coordinates[2 * a + 1],
+			coordinates[2 * b], coordinates[2 * b + 1], x, y);
+		if (orientation == 0.0)
+		{
+			pending_vertices.push_back(vertex);
+			return vertex;
+		}
+		if (orientation > 0.0)
+			create_first_triangle(a, b, vertex);
+		else
+			create_first_triangle(b, a, vertex);
+
+		// the other collinear vertices are inserted normally now
+		std::vector<uint32_t> rest(pending_vertices.begin() + 2, pending_vertices.end());
+		pending_vertices.clear();
+		for (uint32_t other : rest)
+			insert_vertex(other);
+		return vertex;
+	}
+
+	const uint32_t start = locate(x, y);
+	if (!is_ghost(start))
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			const uint32_t other = triangle_slots[start].vertices[i];
+			if (same_position(other)) return other;
+		}
+	}
+
+	// the cavity are all triangles in conflict with the vertex, which are connected to the located one
+	insertion++;
+	const uint32_t tested = 2 * insertion, conflict = 2 * insertion + 1;
+	cavity_stack.clear();
+	cavity_triangles.clear();
+	cavity_edges.clear();
+	triangle_slots[start].mark = conflict;
+	cavity_stack.push_back(start);
+	while (!cavity_stack.empty())
+	{
+		const uint32_t current = cavity_stack.back();
+		cavity_stack.pop_back();
+		cavity_triangles.push_back(current);
+		for (int i = 0; i < 3; i++)
+		{
+			const uint32_t neighbor = triangle_slots[current].neighbors[i];
+			uint32_t& mark = triangle_slots[neighbor].mark;
+			if (mark != tested && mark != conflict)
+			{
+				mark = in_conflict(neighbor, x, y) ? conflict : tested;
+				if (mark == conflict)
+				{
+					cavity_stack.push_back(neighbor);
+					continue;
+				}
+			}
+			if (mark == tested)
+			{
+				const uint32_t* v = triangle_slots[current].vertices;
+				cavity_edges.push_back({ v[(i + 1) % 3], v[(i + 2) % 3], neighbor });
+			}
+		}
+	}
+
+	// connects each boundary edge of the cavity with the vertex, reusing the slots of the cavity
+	const auto slot = [](uint32_t v)
+	{
+		return v == INVALID ? 0 : static_cast<size_t>(v) + 1;
+	};
+	new_triangles.clear();
+	size_t reused = 0;
+	for (const CavityEdge& edge : cavity_edges)
+	{
+		const uint32_t triangle = reused < cavity_triangles.size() ? cavity_triangles[reused++] : allocate_triangle();
+		uint32_t* v = triangle_slots[triangle].vertices;
+		v[0] = edge.a;
+		v[1] = edge.b;
+		v[2] = vertex;
+		triangle_slots[triangle].neighbors[2] = edge.outside;
+
+		// the outside triangle has the same edge in the opposite direction
+		const uint32_t* outside = triangle_slots[edge.outside].vertices;
+		for (int k = 0; k < 3; k++)
+		{
+			if (outside[(k + 1) % 3] == edge.b && outside[(k + 2) % 3] == edge.a)
+			{
+				triangle_slots[edge.outside].neighbors[k] = triangle;
+				break;
+			}
+		}
+
+		first_vertex_triangles[slot(edge.a)] = triangle;
+		new_triangles.push_back(triangle);
+	}
+	for (; reused < cavity_triangles.size(); reused++)
+	{
+		const uint32_t triangle = cavity_triangles[reused];
+		std::fill_n(triangle_slots[triangle].vertices, 3, DELETED);
+		free_triangles.push_back(triangle);
+	}
+
+	// the new triangle (a, b, vertex) shares the edge (b, vertex) with the new triangle which starts at b
+	for (uint32_t triangle : new_triangles)
+	{
+		const uint32_t* v = triangle_slots[triangle].vertices;
+		const uint32_t next = first_vertex_triangles[slot(v[1])];
+		triangle_slots[triangle].neighbors[0] = next;
+		triangle_slots[next].neighbors[1] = triangle;
+		if (v[0] != INVALID && v[1] != INVALID)
+			last_triangle = triangle;
+	}
+	return vertex;
+}
+
+void DelaunayTriangulation::create_first_triangle(uint32_t a, uint32_t b, uint32_t c)
+{
+	const uint32_t triangle = allocate_triangle();
+	const uint32_t ghosts[3] = { allocate_triangle(), allocate_triangle(), allocate_triangle() };
+	const uint32_t corners[3] = { a, b, c };
+
+	// the ghost opposite of each corner has the reversed edge and the infinite vertex
+	for (int i = 0; i < 3; i++)
+	{
+		const uint32_t ghost = ghosts[i];
+		uint32_t* v = triangle_slots[ghost].vertices;
+		v[0] = corners[(i + 2) % 3];
+		v[1] = corners[(i + 1) % 3];
+		v[2] = INVALID;
+		triangle_slots[triangle].vertices[i] = corners[i];
+		triangle_slots[triangle].neighbors[i] = ghost;
+
+		// the ghost which starts at the second vertex and the ghost which ends at the first vertex
+		uint32_t* n = triangle_slots[ghost].neighbors;
+		n[0] = ghosts[(i + 2) % 3];
+		n[1] = ghosts[(i + 1) % 3];
+		n[2] = triangle;
+	}
+	last_triangle = triangle;
+}
+
+bool DelaunayTriangulation::in_conflict(uint32_t triangle, double x, double y) const
+{
+	const uint32_t* v = triangle_slots[triangle].vertices;
+	for (int k = 0; k < 3; k++)
+	{
+		if (v[k] != INVALID) continue;
+
+		// a ghost conflicts with the open half-plane behind its hull edge and the inside of the edge
+		const double* a = &coordinates[2 * static_cast<size_t>(v[(k + 1) % 3])];
+		const double* b = &coordinates[2 * static_cast<size_t>(v[(k + 2) % 3])];
+		const double orientation = Predicates::orient2d(a[0], a[1], b[0], b[1], x, y);
+		if (orientation != 0.0) return orientation > 0.0;
+		if (a[0] != b[0])
+			return std::min(a[0], b[0]) < x && x < std::max(a[0], b[0]);
+		return std::min(a[1], b[1]) < y && y < std::max(a[1], b[1]);
+	}
+
+	const double* a = &coordinates[2 * static_cast<size_t>(v[0])];
+	const double* b = &coordinates[2 * static_cast<size_t>(v[1])];
+	const double* c = &coordinates[2 * static_cast<size_t>(v[2])];
+	return Predicates::incircle(a[0], a[1], b[0], b[1], c[0], c[1], x, y) > 0.0;
+}
+
+uint32_t DelaunayTriangulation::allocate_triangle()
+{
+	if (!free_triangles.empty())
+	{
+		const uint32_t triangle = free_triangles.back();
+		free_triangles.pop_back();
+		return triangle;
+	}
+	const uint32_t triangle = triangle_slot_count();
+	triangle_slots.push_back({ { DELETED, DELETED, DELETED }, { INVALID, INVALID, INVALID }, 0, 0 });
+	return triangle;
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "primitives/Triangle.h"
+#include "primitives/Vertex.h"
+
+/**
+ * \brief An incremental 2D Delaunay triangulation of the x and y coordinates of vertices. (Bowyer-Watson)
+ * The convex hull is closed with ghost triangles, which share the infinite vertex 'INVALID', so points outside
+ * the hull are inserted like all others. All decisions use the robust predicates of 'Predicates'.
+ */
+class DelaunayTriangulation
+{
+public:
+	/**
+	 * \brief The index of a missing element and of the infinite vertex of the ghost triangles.
+	 */
+	static const uint32_t INVALID = 0xFFFFFFFF;
+
+	/**
+	 * \brief The constructor for an empty triangulation.
+	 */
+	DelaunayTriangulation();
+
+	/**
+	 * \brief The constructor. Inserts the vertices in a biased randomized insertion order. (BRIO)
+	 * The vertex ids are the indices in the list. Duplicated positions are only used once.
+	 * \param vertices The vertices.
+	 */
+	explicit DelaunayTriangulation(const std::vector<Vertex>& vertices);
+
+	/**
+	 * \brief Inserts a vertex.
+	 * \param vertex The vertex.
+	 * \return The id of the vertex. (The id of the existing vertex if the position is already used)
+	 */
+	uint32_t insert(const Vertex& vertex);
+
+	/**
+	 * \brief Returns the number of vertices.
+	 * \return The number of vertices.
+	 */
+	uint32_t vertex_count() const;
+
+	/**
+	 * \brief Returns all vertices.
+	 * \return The vertices.
+	 */
+	const std::vector<Vertex>& get_vertices() const;
+
+	/**
+	 * \brief Returns the vertex ids of all finite triangles. (3 per triangle, counterclockwise)
+	 * \return The vertex ids.
+	 */
+	std::vector<uint32_t> get_indices() const;
+
+	/**
+	 * \brief Returns all finite triangles, e.g. to upload them into a 'Mesh'.
+	 * \return The triangles.
+	 */
+	std::vector<Triangle> get_triangles() const;
+
+	/**
+	 * \brief Returns the number of triangle slots, including ghost and deleted triangles.
+	 * \return The number of slots.
+	 */
+	uint32_t triangle_slot_count() const;
+
+	/**
+	 * \brief Whether a triangle slot is in use.
+	 * \param triangle The triangle.
+	 * \return Is the triangle alive.
+	 */
+	bool is_alive(uint32_t triangle) const;
+
+	/**
+	 * \brief Whether a triangle has the infinite vertex.
+	 * \param triangle The triangle.
+	 * \return Is the triangle a ghost.
+	 */
+	bool is_ghost(uint32_t triangle) const;
+
+	/**
+	 * \brief Returns a vertex of a triangle.
+	 * \param triangle The triangle.
+	 * \param i The corner. (0-2, counterclockwise)
+	 * \return The vertex id.
+	 */
+	uint32_t triangle_vertex(uint32_t triangle, int i) const
+	{
+		return triangle_slots[triangle].vertices[i];
+	}
+
+	/**
+	 * \brief Returns a neighbour of a triangle.
+	 * \param triangle The triangle.
+	 * \param i The corner opposite of the shared edge. (0-2)
+	 * \return The neighbouring triangle.
+	 */
+	uint32_t triangle_neighbor(uint32_t triangle, int i) const
+	{
+		return triangle_slots[triangle].neighbors[i];
+	}
+
+	/**
+	 * \brief Finds a triangle which contains a point by walking from a start triangle.
+	 * \param x The x coordinate.
+	 * \param y The y coordinate.
+	 * \param start The finite triangle to start at. ('INVALID' starts at the last created triangle)
+	 * \return The finite triangle which contains the point or the ghost triangle of the hull edge it lies behind.
+	 * ('INVALID' if there are no triangles yet)
+	 */
+	uint32_t locate(double x, double y, uint32_t start = INVALID) const;
+
+	/**
+	 * \brief Finds the triangles which would be replaced by inserting a point, without changing the triangulation.
+	 * These are the triangles whose circumcircle contains the point.
+	 * \param x The x coordinate.
+	 * \param y The y coordinate.
+	 * \param triangles The triangles.
+	 * \param start The finite triangle to start the walk at. ('INVALID' starts at the last created triangle)
+	 */
+	void find_cavity(double x, double y, std::vector<uint32_t>& triangles, uint32_t start = INVALID) const;
+
+	/**
+	 * \brief Returns the triangles created by the last insertion of a new position.
+	 * The neighbour 2 of each is the unchanged triangle on the other side of the edge opposite of the new vertex.
+	 * \return The triangles.
+	 */
+	const std::vector<uint32_t>& get_new_triangles() const;
+
+private:
+	/**
+	 * \brief A triangle slot. (32 bytes, so the walk and the cavity search touch one cache line per triangle)
+	 */
+	struct TriangleSlot
+	{
+		/**
+		 * \brief The vertices. (counterclockwise, 'INVALID' for the infinite vertex, all 'DELETED' for free slots)
+		 */
+		uint32_t vertices[3];
+
+		/**
+		 * \brief The neighbours. (opposite of the vertex with the same index)
+		 */
+		uint32_t neighbors[3];
+
+		/**
+		 * \brief The insertion in which the triangle was last tested. (2 * insertion + 1 if it was in conflict)
+		 */
+		uint32_t mark;
+
+		/**
+		 * \brief Unused.
+		 */
+		uint32_t padding;
+	};
+
+	/**
+	 * \brief An edge of the cavity of the inserted vertex.
+	 */
+	struct CavityEdge
+	{
+		uint32_t a, b, outside;
+	};
+
+	/**
+	 * \brief Inserts a vertex which is already in the vertex list.
+	 * \param vertex The vertex id.
+	 * \return The id of the vertex or of the existing vertex at the same position.
+	 */
+	uint32_t insert_vertex(uint32_t vertex);
+
+	/**
+	 * \brief Creates the first triangle and its ghosts.
+	 * \param a The first vertex.
+	 * \param b The second vertex.
+	 * \param c The third vertex. (not collinear)
+	 */
+	void create_first_triangle(uint32_t a, uint32_t b, uint32_t c);
+
+	/**
+	 * \brief Whether a point lies in the circumcircle of a triangle (or in the outer half-plane of a ghost).
+	 * \param triangle The triangle.
+	 * \param x The x coordinate.
+	 * \param y The y coordinate.
+	 * \return Is the triangle in conflict with the point.
+	 */
+	bool in_conflict(uint32_t triangle, double x, double y) const;
+
+	/**
+	 * \brief Returns a new triangle slot.
+	 * \return The triangle.
+	 */
+	uint32_t allocate_triangle();
+
+	/**
+	 * \brief All vertices.
+	 */
+	std::vector<Vertex> vertices;
+
+	/**
+	 * \brief The coordinates of the vertices in double precision. (x, y per vertex)
+	 */
+	std::vector<double> coordinates;
+
+	/**
+	 * \brief The triangles, including ghost and free slots.
+	 */
+	std::vector<TriangleSlot> triangle_slots;
+
+	/**
+	 * \brief The free triangle slots.
+	 */
+	std::vector<uint32_t> free_triangles;
+
+	/**
+	 * \brief The vertices inserted before the first triangle exists, because all were collinear.
+	 */
+	std::vector<uint32_t> pending_vertices;
+
+	/**
+	 * \brief The last created finite triangle, where the next walk starts.
+	 */
+	uint32_t last_triangle;
+
+	/**
+	 * \brief The number of insertions.
+	 */
+	uint32_t insertion;
+
+	/**
+	 * \brief Scratch buffers of the insertion.
+	 */
+	std::vector<uint32_t> cavity_stack, cavity_triangles, new_triangles, first_vertex_triangles;
+
+	/**
+	 * \brief Scratch buffer of the boundary of the cavity.
+	 */
+	std::vector<CavityEdge> cavity_edges;
+};
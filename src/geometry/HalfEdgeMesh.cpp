@@ -0,0 +1,263 @@
+#include "HalfEdgeMesh.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "utilities/Parallel.h"
+
+namespace
+{
+	/**
+	 * \brief The key of an unused slot in the edge table. (No edge has this key, because vertex ids are below 'INVALID')
+	 */
+	const uint64_t EMPTY_KEY = ~0ull;
+
+	/**
+	 * \brief The half-edge of an edge direction which is used by more than one half-edge.
+	 */
+	const uint32_t DUPLICATE_EDGE = HalfEdgeMesh::INVALID - 1;
+
+	/**
+	 * \brief Returns the key of two vertices.
+	 */
+	inline uint64_t edge_key(uint32_t a, uint32_t b)
+	{
+		return static_cast<uint64_t>(a) << 32 | b;
+	}
+
+	/**
+	 * \brief Mixes the bits of a key. (splitmix64 finalizer)
+	 */
+	inline uint64_t hash(uint64_t key)
+	{
+		key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+		key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+		return key ^ (key >> 31);
+	}
+
+	/**
+	 * \brief A fixed size hash table from undirected edges to their two half-edges with open addressing.
+	 * Can be filled from several threads at once.
+	 */
+	class EdgeTable
+	{
+	public:
+		/**
+		 * \brief An undirected edge and its half-edge per direction in 16 bytes.
+		 */
+		struct Slot
+		{
+			std::atomic<uint64_t> key;
+			std::atomic<uint32_t> half_edges[2];
+		};
+
+		explicit EdgeTable(size_t edge_count)
+		{
+			capacity = 16;
+			while (capacity < 2 * edge_count) capacity *= 2;
+			slots.reset(new Slot[capacity]);
+			Utilities::parallel_for(capacity, [&](size_t begin, size_t end, unsigned int)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					slots[i].key.store(EMPTY_KEY, std::memory_order_relaxed);
+					slots[i].half_edges[0].store(HalfEdgeMesh::INVALID, std::memory_order_relaxed);
+					slots[i].half_edges[1].store(HalfEdgeMesh::INVALID, std::memory_order_relaxed);
+				}
+			}, 1 << 16);
+		}
+
+		void insert(uint32_t origin, uint32_t target, uint32_t half_edge)
+		{
+			const uint64_t key = edge_key(std::min(origin, target), std::max(origin, target));
+			for (size_t i = hash(key) & (capacity - 1);; i = (i + 1) & (capacity - 1))
+			{
+				Slot& slot = slots[i];
+				uint64_t expected = slot.key.load(std::memory_order_relaxed);
+				if (expected == key || (expected == EMPTY_KEY && (slot.key.compare_exchange_strong(expected, key) || expected == key)))
+				{
+					// the first half-edge per direction wins, all others mark the direction as duplicate
+					std::atomic<uint32_t>& value = slot.half_edges[origin > target];
+					uint32_t empty = HalfEdgeMesh::INVALID;
+					if (!value.compare_exchange_strong(empty, half_edge))
+						value.store(DUPLICATE_EDGE);
+					return;
+				}
+			}
+		}
+
+		const Slot& find(uint32_t origin, uint32_t target) const
+		{
+			const uint64_t key = edge_key(std::min(origin, target), std::max(origin, target));
+			for (size_t i = hash(key) & (capacity - 1);; i = (i + 1) & (capacity - 1))
+			{
+				if (slots[i].key.load(std::memory_order_relaxed) == key) return slots[i];
+			}
+		}
+
+	private:
+		size_t capacity;
+		std::unique_ptr<Slot[]> slots;
+	};
+
+	/**
+	 * \brief Hashes the bits of a position for the welding.
+	 */
+	struct PositionHash
+	{
+		size_t operator()(const Vec3f& p) const
+		{
+			uint32_t bits[3];
+			std::memcpy(bits, &p, sizeof(bits));
+			return static_cast<size_t>(hash(edge_key(bits[0], bits[1]) ^ hash(bits[2])));
+		}
+	};
+
+	/**
+	 * \brief Compares positions exactly for the welding.
+	 */
+	struct PositionEqual
+	{
+		bool operator()(const Vec3f& a, const Vec3f& b) const
+		{
+			return a.x == b.x && a.y == b.y && a.z == b.z;
+		}
+	};
+}
+
+const uint32_t HalfEdgeMesh::INVALID;
+
+HalfEdgeMesh::HalfEdgeMesh()
+{
+}
+
+HalfEdgeMesh::HalfEdgeMesh(std::vector<uint32_t> indices, std::vector<Vec3f> positions)
+	: origins(std::move(indices)), positions(std::move(positions))
+{
+	check_indices();
+	build_twins();
+	build_vertex_half_edges();
+}
+
+HalfEdgeMesh::HalfEdgeMesh(std::vector<uint32_t> indices, std::vector<uint32_t> twins, std::vector<Vec3f> positions)
+	: origins(std::move(indices)), twins(std::move(twins)), positions(std::move(positions))
+{
+	check_indices();
+	if (this->twins.size() != origins.size())
+		throw std::invalid_argument("'HalfEdgeMesh' should only be created with one twin per half-edge.");
+	build_vertex_half_edges();
+}
+
+HalfEdgeMesh HalfEdgeMesh::from_triangles(const std::vector<Triangle>& triangles)
+{
+	std::vector<uint32_t> indices(3 * triangles.size());
+	std::vector<Vec3f> positions;
+	std::unordered_map<Vec3f, uint32_t, PositionHash, PositionEqual> ids;
+	ids.reserve(triangles.size());
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		for (int v = 0; v < 3; v++)
+		{
+			// adding 0 turns -0 into 0, so both are merged
+			const Vec4f& p = triangles[i].vertices[v].position;
+			const Vec3f position(p.x + 0.f, p.y + 0.f, p.z + 0.f);
+			const auto inserted = ids.insert(std::make_pair(position, static_cast<uint32_t>(positions.size())));
+			if (inserted.second)
+				positions.push_back(position);
+			indices[3 * i + v] = inserted.first->second;
+		}
+	}
+	return HalfEdgeMesh(std::move(indices), std::move(positions));
+}
+
+bool HalfEdgeMesh::empty() const
+{
+	return origins.empty();
+}
+
+uint32_t HalfEdgeMesh::face_count() const
+{
+	return static_cast<uint32_t>(origins.size() / 3);
+}
+
+uint32_t HalfEdgeMesh::half_edge_count() const
+{
+	return static_cast<uint32_t>(origins.size());
+}
+
+uint32_t HalfEdgeMesh::vertex_count() const
+{
+	return static_cast<uint32_t>(positions.size());
+}
+
+const std::vector<uint32_t>& HalfEdgeMesh::get_indices() const
+{
+	return origins;
+}
+
+const std::vector<Vec3f>& HalfEdgeMesh::get_positions() const
+{
+	return positions;
+}
+
+void HalfEdgeMesh::check_indices() const
+{
+	if (origins.size() % 3 != 0)
+		throw std::invalid_argument("'HalfEdgeMesh' should only be created with 3 indices per face.");
+	if (origins.size() >= INVALID - 1 || positions.size() >= INVALID)
+		throw std::invalid_argument("'HalfEdgeMesh' only supports 32 bit indices.");
+	for (uint32_t vertex : origins)
+	{
+		if (vertex >= positions.size())
+			throw std::invalid_argument("'HalfEdgeMesh' should only be created with valid vertex indices.");
+	}
+}
+
+void HalfEdgeMesh::build_twins()
+{
+	const size_t count = origins.size();
+	twins.assign(count, INVALID);
+	if (count == 0) return;
+
+	// inserts all half-edges (a closed manifold mesh has half as many edges)
+	EdgeTable table(count / 2 + 1);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t h = begin; h < end; h++)
+		{
+			const uint32_t a = origins[h], b = target(static_cast<uint32_t>(h));
+			if (a != b)
+				table.insert(a, b, static_cast<uint32_t>(h));
+		}
+	}, 4096);
+
+	// the twin is the reversed edge, if both directions are used exactly once
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t h = begin; h < end; h++)
+		{
+			const uint32_t a = origins[h], b = target(static_cast<uint32_t>(h));
+			if (a == b) continue;
+			const EdgeTable::Slot& slot = table.find(a, b);
+			const uint32_t twin = slot.half_edges[a < b].load(std::memory_order_relaxed);
+			if (slot.half_edges[a > b].load(std::memory_order_relaxed) == h && twin != DUPLICATE_EDGE)
+				twins[h] = twin;
+		}
+	}, 4096);
+}
+
+void HalfEdgeMesh::build_vertex_half_edges()
+{
+	// prefers the boundary half-edges, so that the rotation around a boundary vertex starts at the boundary
+	vertex_half_edges.assign(positions.size(), INVALID);
+	for (uint32_t h = 0; h < origins.size(); h++)
+	{
+		uint32_t& current = vertex_half_edges[origins[h]];
+		if (current == INVALID || (twins[h] == INVALID && twins[current] != INVALID))
+			current = h;
+	}
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/Vec3f.h"
+#include "primitives/Triangle.h"
+
+/**
+ * \brief An index based half-edge structure of a triangle mesh. (corner table)
+ * The half-edges of face f are 3f, 3f+1 and 3f+2, so 'next', 'prev' and 'face' are implicit
+ * and only the origin vertex and the twin are stored per half-edge.
+ * The face ids are the triangle ids of the mesh it was built from.
+ */
+class HalfEdgeMesh
+{
+public:
+	/**
+	 * \brief The index of a missing element. (e.g. the twin of a boundary half-edge)
+	 */
+	static const uint32_t INVALID = 0xFFFFFFFF;
+
+	/**
+	 * \brief The constructor for an empty mesh.
+	 */
+	HalfEdgeMesh();
+
+	/**
+	 * \brief The constructor. Matches the twins in parallel.
+	 * Edges which are shared by more than two faces or by two faces with the same orientation stay boundary edges.
+	 * \param indices The vertex indices. (3 per face)
+	 * \param positions The vertex positions.
+	 */
+	HalfEdgeMesh(std::vector<uint32_t> indices, std::vector<Vec3f> positions);
+
+	/**
+	 * \brief The constructor for a mesh whose twins are already known. (e.g. from a refinement of another mesh)
+	 * Skips the edge table, so the twins have to be symmetric.
+	 * \param indices The vertex indices. (3 per face)
+	 * \param twins The twin of each half-edge. ('INVALID' on the boundary)
+	 * \param positions The vertex positions.
+	 */
+	HalfEdgeMesh(std::vector<uint32_t> indices, std::vector<uint32_t> twins, std::vector<Vec3f> positions);
+
+	/**
+	 * \brief Creates the mesh of a triangle list. Vertices with exactly the same position are merged.
+	 * \param triangles The triangles. (e.g. of 'Mesh::get_triangles')
+	 * \return The mesh.
+	 */
+	static HalfEdgeMesh from_triangles(const std::vector<Triangle>& triangles);
+
+	/**
+	 * \brief Whether the mesh has no faces.
+	 * \return Is the mesh empty.
+	 */
+	bool empty() const;
+
+	/**
+	 * \brief Returns the number of faces.
+	 * \return The number of faces.
+	 */
+	uint32_t face_count() const;
+
+	/**
+	 * \brief Returns the number of half-edges. (3 per face)
+	 * \return The number of half-edges.
+	 */
+	uint32_t half_edge_count() const;
+
+	/**
+	 * \brief Returns the number of vertices.
+	 * \return The number of vertices.
+	 */
+	uint32_t vertex_count() const;
+
+	/**
+	 * \brief Returns the face of a half-edge.
+	 * \param half_edge The half-edge.
+	 * \return The face.
+	 */
+	static uint32_t face(uint32_t half_edge)
+	{
+		return half_edge / 3;
+	}
+
+	/**
+	 * \brief Returns the first half-edge of a face.
+	 * \param face The face.
+	 * \return The half-edge.
+	 */
+	static uint32_t half_edge(uint32_t face)
+	{
+		return 3 * face;
+	}
+
+	/**
+	 * \brief Returns the next half-edge in the same face.
+	 * \param half_edge The half-edge.
+	 * \return The next half-edge.
+	 */
+	static uint32_t next(uint32_t half_edge)
+	{
+		return half_edge % 3 == 2 ? half_edge - 2 : half_edge + 1;
+	}
+
+	/**
+	 * \brief Returns the previous half-edge in the same face.
+	 * \param half_edge The half-edge.
+	 * \return The previous half-edge.
+	 */
+	static uint32_t prev(uint32_t half_edge)
+	{
+		return half_edge % 3 == 0 ? half_edge + 2 : half_edge - 1;
+	}
+
+	/**
+	 * \brief Returns the opposite half-edge in the neighbouring face.
+	 * \param half_edge The half-edge.
+	 * \return The twin. ('INVALID' on the boundary)
+	 */
+	uint32_t twin(uint32_t half_edge) const
+	{
+		return twins[half_edge];
+	}
+
+	/**
+	 * \brief Returns the vertex a half-edge starts at.
+	 * \param half_edge The half-edge.
+	 * \return The vertex.
+	 */
+	uint32_t origin(uint32_t half_edge) const
+	{
+		return origins[half_edge];
+	}
+
+	/**
+	 * \brief Returns the vertex a half-edge ends at.
+	 * \param half_edge The half-edge.
+	 * \return The vertex.
+	 */
+	uint32_t target(uint32_t half_edge) const
+	{
+		return origins[next(half_edge)];
+	}
+
+	/**
+	 * \brief Returns an outgoing half-edge of a vertex.
+	 * On the boundary this is the outgoing boundary half-edge, so 'rotate' reaches all faces around the vertex.
+	 * \param vertex The vertex.
+	 * \return The half-edge. ('INVALID' for isolated vertices)
+	 */
+	uint32_t vertex_half_edge(uint32_t vertex) const
+	{
+		return vertex_half_edges[vertex];
+	}
+
+	/**
+	 * \brief Returns the next outgoing half-edge of the same vertex in counterclockwise order.
+	 * \param half_edge The outgoing half-edge.
+	 * \return The next outgoing half-edge. ('INVALID' at the boundary)
+	 */
+	uint32_t rotate(uint32_t half_edge) const
+	{
+		return twins[prev(half_edge)];
+	}
+
+	/**
+	 * \brief Whether a half-edge lies on the boundary.
+	 * \param half_edge The half-edge.
+	 * \return Is the half-edge on the boundary.
+	 */
+	bool is_boundary_edge(uint32_t half_edge) const
+	{
+		return twins[half_edge] == INVALID;
+	}
+
+	/**
+	 * \brief Whether a vertex lies on the boundary. (Isolated vertices count as boundary)
+	 * \param vertex The vertex.
+	 * \return Is the vertex on the boundary.
+	 */
+	bool is_boundary_vertex(uint32_t vertex) const
+	{
+		const uint32_t h = vertex_half_edges[vertex];
+		return h == INVALID || twins[h] == INVALID;
+	}
+
+	/**
+	 * \brief Returns the position of a vertex.
+	 * \param vertex The vertex.
+	 * \return The position.
+	 */
+	Vec3f position(uint32_t vertex) const
+	{
+		return positions[vertex];
+	}
+
+	/**
+	 * \brief Returns the origin vertex of each half-edge. (equals the vertex indices of the faces)
+	 * \return The vertex indices.
+	 */
+	const std::vector<uint32_t>& get_indices() const;
+
+	/**
+	 * \brief Returns the positions of all vertices.
+	 * \return The positions.
+	 */
+	const std::vector<Vec3f>& get_positions() const;
+
+private:
+	/**
+	 * \brief Checks the number and the range of the vertex indices.
+	 */
+	void check_indices() const;
+
+	/**
+	 * \brief Matches the twins with a concurrent hash table of the directed edges.
+	 */
+	void build_twins();
+
+	/**
+	 * \brief Picks the outgoing half-edge of each vertex.
+	 */
+	void build_vertex_half_edges();
+
+	/**
+	 * \brief The origin vertex of each half-edge.
+	 */
+	std::vector<uint32_t> origins;
+
+	/**
+	 * \brief The twin of each half-edge.
+	 */
+	std::vector<uint32_t> twins;
+
+	/**
+	 * \brief An outgoing half-edge of each vertex.
+	 */
+	std::vector<uint32_t> vertex_half_edges;
+
+	/**
+	 * \brief The positions of the vertices.
+	 */
+	std::vector<Vec3f> positions;
+};
@@ -0,0 +1,214 @@
+#include "HandleGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/* The largest cell coordinate, so that projections far outside the window do not overflow: */
+#define HANDLE_GRID_MAX_CELL (1 << 30)
+
+const uint32_t HandleGrid::INVALID;
+
+HandleGrid::HandleGrid(float cell_size)
+	: HandleGrid(std::vector<Vec4f>(), Mat4f(), cell_size)
+{
+}
+
+HandleGrid::HandleGrid(std::vector<Vec4f> positions, Mat4f model_matrix, float cell_size)
+	: cell_size(cell_size), model_matrix(model_matrix), positions(std::move(positions)),
+	cell_bounds{ HANDLE_GRID_MAX_CELL, HANDLE_GRID_MAX_CELL, -HANDLE_GRID_MAX_CELL, -HANDLE_GRID_MAX_CELL }
+{
+	if (!(cell_size > 0.f))
+		throw std::invalid_argument("'HandleGrid' should only be called with a positive cell size.");
+	if (this->positions.size() >= INVALID)
+		throw std::invalid_argument("'HandleGrid' only supports 32 bit handle ids.");
+
+	screen_handles.resize(this->positions.size());
+	for (uint32_t handle = 0; handle < this->positions.size(); handle++)
+		insert(handle);
+}
+
+uint32_t HandleGrid::handle_count() const
+{
+	return static_cast<uint32_t>(positions.size());
+}
+
+Vec4f HandleGrid::get_position(uint32_t handle) const
+{
+	return positions[handle];
+}
+
+const std::vector<Vec4f>& HandleGrid::get_positions() const
+{
+	return positions;
+}
+
+uint32_t HandleGrid::add(Vec4f position)
+{
+	if (positions.size() + 1 >= INVALID)
+		throw std::invalid_argument("'HandleGrid' only supports 32 bit handle ids.");
+
+	const uint32_t handle = static_cast<uint32_t>(positions.size());
+	positions.push_back(position);
+	screen_handles.emplace_back();
+	insert(handle);
+	return handle;
+}
+
+void HandleGrid::move(uint32_t handle, Vec4f position)
+{
+	if (handle >= positions.size())
+		throw std::invalid_argument("'HandleGrid::move' should only be called with existing handles.");
+
+	positions[handle] = position;
+	remove(handle);
+	insert(handle);
+}
+
+void HandleGrid::set_model_matrix(Mat4f model_matrix)
+{
+	bool changed = false;
+	for (int column = 0; column < 4; column++)
+	{
+		for (int row = 0; row < 4; row++)
+			changed |= model_matrix[column][row] != this->model_matrix[column][row];
+	}
+	if (!changed)
+		return;
+
+	this->model_matrix = model_matrix;
+	cells.clear();
+	cell_bounds[0] = cell_bounds[1] = HANDLE_GRID_MAX_CELL;
+	cell_bounds[2] = cell_bounds[3] = -HANDLE_GRID_MAX_CELL;
+	for (uint32_t handle = 0; handle < positions.size(); handle++)
+		insert(handle);
+}
+
+uint32_t HandleGrid::find_nearest(float x, float y, float max_distance) const
+{
+	uint32_t nearest = INVALID;
+	float nearest_distance = max_distance * max_distance;
+	if (cells.empty())
+		return nearest;
+
+	// visits rings of cells around the point until the next ring can not contain a nearer handle
+	const int32_t center_x = cell_coordinate(x), center_y = cell_coordinate(y);
+	for (int32_t ring = 0;; ring++)
+	{
+		if (ring > 0)
+		{
+			// the distance to the border of the cells visited so far
+			const float inner = std::min(
+				std::min(x - static_cast<float>(center_x - ring + 1) * cell_size, static_cast<float>(center_x + ring) * cell_size - x),
+				std::min(y - static_cast<float>(center_y - ring + 1) * cell_size, static_cast<float>(center_y + ring) * cell_size - y));
+			if (inner * inner > nearest_distance)
+				return nearest;
+			// all cells with handles were visited
+			if (center_x - ring < cell_bounds[0] && center_y - ring < cell_bounds[1] &&
+				center_x + ring > cell_bounds[2] && center_y + ring > cell_bounds[3])
+				return nearest;
+			// the rings have more cells than there are cells with handles, so these are visited directly
+			const size_t side = 2 * static_cast<size_t>(ring) + 1;
+			if (side * side > cells.size())
+				break;
+		}
+
+		const int32_t min_x = std::max(center_x - ring, cell_bounds[0]), max_x = std::min(center_x + ring, cell_bounds[2]);
+		const int32_t min_y = std::max(center_y - ring, cell_bounds[1]), max_y = std::min(center_y + ring, cell_bounds[3]);
+		for (int32_t cell_y = min_y; cell_y <= max_y; cell_y++)
+		{
+			if (cell_y == center_y - ring || cell_y == center_y + ring)
+			{
+				// the first and the last row of the ring
+				for (int32_t cell_x = min_x; cell_x <= max_x; cell_x++)
+					visit_cell(cell_key(cell_x, cell_y), x, y, nearest, nearest_distance);
+				continue;
+			}
+			if (center_x - ring >= min_x)
+				visit_cell(cell_key(center_x - ring, cell_y), x, y, nearest, nearest_distance);
+			if (center_x + ring <= max_x)
+				visit_cell(cell_key(center_x + ring, cell_y), x, y, nearest, nearest_distance);
+		}
+	}
+
+	// visits the cells with handles sorted by their distance, until they are too far away
+	std::vector<std::pair<float, uint64_t>> candidates;
+	candidates.reserve(cells.size());
+	for (const auto& cell : cells)
+	{
+		const float cell_x = static_cast<float>(static_cast<int32_t>(cell.first >> 32)) * cell_size;
+		const float cell_y = static_cast<float>(static_cast<int32_t>(cell.first & 0xFFFFFFFFull)) * cell_size;
+		const float dx = std::max(std::max(cell_x - x, x - cell_x - cell_size), 0.f);
+		const float dy = std::max(std::max(cell_y - y, y - cell_y - cell_size), 0.f);
+		if (dx * dx + dy * dy <= nearest_distance)
+			candidates.emplace_back(dx * dx + dy * dy, cell.first);
+	}
+	std::sort(candidates.begin(), candidates.end());
+	for (const auto& candidate : candidates)
+	{
+		if (candidate.first > nearest_distance)
+			break;
+		visit_cell(candidate.second, x, y, nearest, nearest_distance);
+	}
+	return nearest;
+}
+
+int32_t HandleGrid::cell_coordinate(float value) const
+{
+	const float cell = std::floor(value / cell_size);
+	const float limit = static_cast<float>(HANDLE_GRID_MAX_CELL);
+	return static_cast<int32_t>(std::max(-limit, std::min(limit, cell)));
+}
+
+uint64_t HandleGrid::cell_key(int32_t x, int32_t y)
+{
+	return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+}
+
+void HandleGrid::insert(uint32_t handle)
+{
+	const Vec4f projected = model_matrix * positions[handle];
+	const int32_t x = cell_coordinate(projected.x), y = cell_coordinate(projected.y);
+	cell_bounds[0] = std::min(cell_bounds[0], x);
+	cell_bounds[1] = std::min(cell_bounds[1], y);
+	cell_bounds[2] = std::max(cell_bounds[2], x);
+	cell_bounds[3] = std::max(cell_bounds[3], y);
+
+	ScreenHandle& screen_handle = screen_handles[handle];
+	screen_handle.x = projected.x;
+	screen_handle.y = projected.y;
+	screen_handle.cell = cell_key(x, y);
+	std::vector<uint32_t>& cell = cells[screen_handle.cell];
+	screen_handle.slot = static_cast<uint32_t>(cell.size());
+	cell.push_back(handle);
+}
+
+void HandleGrid::remove(uint32_t handle)
+{
+	// moves the last handle of the cell into the slot
+	const ScreenHandle& screen_handle = screen_handles[handle];
+	const auto cell = cells.find(screen_handle.cell);
+	std::vector<uint32_t>& handles = cell->second;
+	handles[screen_handle.slot] = handles.back();
+	screen_handles[handles.back()].slot = screen_handle.slot;
+	handles.pop_back();
+	if (handles.empty())
+		cells.erase(cell);
+}
+
+void HandleGrid::visit_cell(uint64_t key, float x, float y, uint32_t& nearest, float& nearest_distance) const
+{
+	const auto cell = cells.find(key);
+	if (cell == cells.end())
+		return;
+	for (uint32_t handle : cell->second)
+	{
+		const float dx = screen_handles[handle].x - x, dy = screen_handles[handle].y - y;
+		const float distance = dx * dx + dy * dy;
+		if (distance < nearest_distance || (distance == nearest_distance && (nearest == INVALID || handle > nearest)))
+		{
+			nearest = handle;
+			nearest_distance = distance;
+		}
+	}
+}
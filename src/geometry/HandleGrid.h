@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "math/Mat4f.h"
+#include "math/Vec4f.h"
+
+/* The default edge length of the cells in pixels: */
+#define HANDLE_GRID_CELL_SIZE 16.f
+
+/**
+ * \brief A picking index of draggable handles, which finds the handle nearest to the mouse in screen space.
+ * The handles are projected with the model matrix and hashed into square cells, so a query only looks at
+ * the cells around the mouse. Moving a handle only updates its own cell, only a new model matrix reprojects all.
+ */
+class HandleGrid
+{
+public:
+	/**
+	 * \brief The index of a missing handle.
+	 */
+	static const uint32_t INVALID = 0xFFFFFFFF;
+
+	/**
+	 * \brief The constructor for an empty grid.
+	 * \param cell_size The edge length of the cells in pixels.
+	 */
+	explicit HandleGrid(float cell_size = HANDLE_GRID_CELL_SIZE);
+
+	/**
+	 * \brief The constructor.
+	 * \param positions The positions of the handles. (in model space)
+	 * \param model_matrix The model matrix, which maps model space to pixels around the center of the window.
+	 * \param cell_size The edge length of the cells in pixels.
+	 */
+	HandleGrid(std::vector<Vec4f> positions, Mat4f model_matrix, float cell_size = HANDLE_GRID_CELL_SIZE);
+
+	/**
+	 * \brief Returns the number of handles.
+	 * \return The number of handles.
+	 */
+	uint32_t handle_count() const;
+
+	/**
+	 * \brief Returns the position of a handle.
+	 * \param handle The handle.
+	 * \return The position. (in model space)
+	 */
+	Vec4f get_position(uint32_t handle) const;
+
+	/**
+	 * \brief Returns the positions of all handles.
+	 * \return The positions. (in model space)
+	 */
+	const std::vector<Vec4f>& get_positions() const;
+
+	/**
+	 * \brief Adds a handle.
+	 * \param position The position. (in model space)
+	 * \return The id of the handle.
+	 */
+	uint32_t add(Vec4f position);
+
+	/**
+	 * \brief Moves a handle and updates its cell.
+	 * \param handle The handle.
+	 * \param position The new position. (in model space)
+	 */
+	void move(uint32_t handle, Vec4f position);
+
+	/**
+	 * \brief Changes the model matrix and reprojects all handles. Does nothing if the matrix did not change.
+	 * \param model_matrix The model matrix.
+	 */
+	void set_model_matrix(Mat4f model_matrix);
+
+	/**
+	 * \brief Finds the handle nearest to a point on the screen. On equal distances the handle with the higher id wins.
+	 * \param x The x coordinate in pixels. (0 at the center of the window, as in 'Utilities::get_mouse_position')
+	 * \param y The y coordinate in pixels.
+	 * \param max_distance The maximum distance in pixels.
+	 * \return The handle. ('INVALID' if no handle is close enough)
+	 */
+	uint32_t find_nearest(float x, float y, float max_distance = std::numeric_limits<float>::infinity()) const;
+
+private:
+	/**
+	 * \brief The projection of a handle and where it is stored.
+	 */
+	struct ScreenHandle
+	{
+		float x, y;
+		uint64_t cell;
+		uint32_t slot;
+	};
+
+	/**
+	 * \brief Returns the cell coordinate of a screen coordinate.
+	 * \param value The screen coordinate.
+	 * \return The cell coordinate.
+	 */
+	int32_t cell_coordinate(float value) const;
+
+	/**
+	 * \brief Returns the key of a cell.
+	 * \param x The x coordinate of the cell.
+	 * \param y The y coordinate of the cell.
+	 * \return The key.
+	 */
+	static uint64_t cell_key(int32_t x, int32_t y);
+
+	/**
+	 * \brief Projects a handle and inserts it into its cell.
+	 * \param handle The handle.
+	 */
+	void insert(uint32_t handle);
+
+	/**
+	 * \brief Removes a handle from its cell.
+	 * \param handle The handle.
+	 */
+	void remove(uint32_t handle);
+
+	/**
+	 * \brief Tests the handles of a cell against the nearest handle so far.
+	 * \param key The key of the cell.
+	 * \param x The x coordinate in pixels.
+	 * \param y The y coordinate in pixels.
+	 * \param nearest The nearest handle so far.
+	 * \param nearest_distance The squared distance of the nearest handle so far.
+	 */
+	void visit_cell(uint64_t key, float x, float y, uint32_t& nearest, float& nearest_distance) const;
+
+	/**
+	 * \brief The edge length of the cells in pixels.
+	 */
+	float cell_size;
+
+	/**
+	 * \brief The model matrix.
+	 */
+	Mat4f model_matrix;
+
+	/**
+	 * \brief The positions of the handles. (in model space)
+	 */
+	std::vector<Vec4f> positions;
+
+	/**
+	 * \brief The projections of the handles.
+	 */
+	std::vector<ScreenHandle> screen_handles;
+
+	/**
+	 * \brief The handles in each non-empty cell.
+	 */
+	std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+
+	/**
+	 * \brief The range of the cells which ever contained a handle. (min x, min y, max x, max y)
+	 */
+	int32_t cell_bounds[4];
+};
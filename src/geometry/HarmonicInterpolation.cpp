@@ -0,0 +1,76 @@
+#include "HarmonicInterpolation.h"
+
+#include <stdexcept>
+
+HarmonicInterpolation::HarmonicInterpolation(const CotangentLaplacian& laplacian, const std::vector<uint32_t>& fixed_vertices)
+	: fixed(fixed_mask(laplacian.get_stiffness().row_count(), fixed_vertices)),
+	indices(vertex_indices(fixed, fixed_vertices)),
+	free_count(laplacian.get_stiffness().row_count() - static_cast<uint32_t>(fixed_vertices.size())),
+	coupling(block(laplacian.get_stiffness(), true)),
+	solver(block(laplacian.get_stiffness(), false))
+{
+}
+
+std::vector<double> HarmonicInterpolation::interpolate(const std::vector<double>& fixed_values) const
+{
+	if (fixed_values.size() != coupling.column_count())
+		throw std::invalid_argument("'HarmonicInterpolation::interpolate' should only be called with one value per fixed vertex.");
+
+	// L_ff u_f = -L_fc u_c
+	std::vector<double> right_side = coupling.multiply(fixed_values);
+	for (double& value : right_side)
+		value = -value;
+	std::vector<double> free_values;
+	solver.solve(right_side, free_values);
+
+	std::vector<double> values(fixed.size());
+	for (size_t vertex = 0; vertex < fixed.size(); vertex++)
+		values[vertex] = fixed[vertex] ? fixed_values[indices[vertex]] : free_values[indices[vertex]];
+	return values;
+}
+
+std::vector<bool> HarmonicInterpolation::fixed_mask(uint32_t vertex_count, const std::vector<uint32_t>& fixed_vertices)
+{
+	std::vector<bool> mask(vertex_count, false);
+	for (uint32_t vertex : fixed_vertices)
+	{
+		if (vertex >= vertex_count || mask[vertex])
+			throw std::invalid_argument("'HarmonicInterpolation' should only be called with unique vertices of the mesh.");
+		mask[vertex] = true;
+	}
+	return mask;
+}
+
+std::vector<uint32_t> HarmonicInterpolation::vertex_indices(const std::vector<bool>& fixed, const std::vector<uint32_t>& fixed_vertices)
+{
+	std::vector<uint32_t> result(fixed.size());
+	uint32_t free_index = 0;
+	for (size_t vertex = 0; vertex < fixed.size(); vertex++)
+	{
+		if (!fixed[vertex])
+			result[vertex] = free_index++;
+	}
+	for (uint32_t i = 0; i < fixed_vertices.size(); i++)
+		result[fixed_vertices[i]] = i;
+	return result;
+}
+
+SparseMatrix HarmonicInterpolation::block(const SparseMatrix& stiffness, bool fixed_columns) const
+{
+	const std::vector<uint32_t>& row_begins = stiffness.get_row_begins();
+	const std::vector<uint32_t>& columns = stiffness.get_columns();
+	const std::vector<double>& values = stiffness.get_values();
+	std::vector<SparseEntry> entries;
+	for (uint32_t row = 0; row < stiffness.row_count(); row++)
+	{
+		if (fixed[row])
+			continue;
+		for (uint32_t i = row_begins[row]; i < row_begins[row + 1]; i++)
+		{
+			if (fixed[columns[i]] == fixed_columns)
+				entries.push_back({ indices[row], indices[columns[i]], values[i] });
+		}
+	}
+	const uint32_t column_count = fixed_columns ? static_cast<uint32_t>(fixed.size()) - free_count : free_count;
+	return SparseMatrix(free_count, column_count, entries);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry/CotangentLaplacian.h"
+#include "math/ConjugateGradient.h"
+#include "math/SparseMatrix.h"
+
+/**
+ * \brief Interpolates values at some vertices smoothly over a mesh by solving the Laplace equation L u = 0 for
+ * the other vertices. (e.g. for deformation weights or parameterizations)
+ * The system of the free vertices is factorized once, so new values at the same fixed vertices only need a solve.
+ * Each connected component of the mesh needs at least one fixed vertex.
+ */
+class HarmonicInterpolation
+{
+public:
+	/**
+	 * \brief The constructor. Builds and factorizes the system of the free vertices.
+	 * \param laplacian The Laplacian of the mesh.
+	 * \param fixed_vertices The vertices with given values. (unique)
+	 */
+	HarmonicInterpolation(const CotangentLaplacian& laplacian, const std::vector<uint32_t>& fixed_vertices);
+
+	/**
+	 * \brief Interpolates values on all threads.
+	 * \param fixed_values The values of the fixed vertices. (in the order of the constructor)
+	 * \return The values of all vertices.
+	 */
+	std::vector<double> interpolate(const std::vector<double>& fixed_values) const;
+
+private:
+	/**
+	 * \brief Marks the fixed vertices.
+	 * \param vertex_count The number of vertices.
+	 * \param fixed_vertices The fixed vertices.
+	 * \return Whether each vertex is fixed.
+	 */
+	static std::vector<bool> fixed_mask(uint32_t vertex_count, const std::vector<uint32_t>& fixed_vertices);
+
+	/**
+	 * \brief Numbers the free and the fixed vertices separately.
+	 * \param fixed Whether each vertex is fixed.
+	 * \param fixed_vertices The fixed vertices.
+	 * \return The index of each vertex among the free or the fixed vertices.
+	 */
+	static std::vector<uint32_t> vertex_indices(const std::vector<bool>& fixed, const std::vector<uint32_t>& fixed_vertices);
+
+	/**
+	 * \brief Returns the rows of the free vertices of the stiffness matrix.
+	 * \param stiffness The stiffness matrix.
+	 * \param fixed_columns Whether to keep the columns of the fixed vertices (L_fc) instead of the free ones (L_ff).
+	 * \return The block.
+	 */
+	SparseMatrix block(const SparseMatrix& stiffness, bool fixed_columns) const;
+
+	/**
+	 * \brief Whether a vertex is fixed.
+	 */
+	std::vector<bool> fixed;
+
+	/**
+	 * \brief The index of each vertex among the free or the fixed vertices.
+	 */
+	std::vector<uint32_t> indices;
+
+	/**
+	 * \brief The number of free vertices.
+	 */
+	uint32_t free_count;
+
+	/**
+	 * \brief The coupling of the free to the fixed vertices. (L_fc)
+	 */
+	SparseMatrix coupling;
+
+	/**
+	 * \brief The solver of the free vertices. (L_ff)
+	 */
+	ConjugateGradient solver;
+};
@@ -0,0 +1,243 @@
+#include "IntersectionQuery.h"
+
+#include <algorithm>
+
+#include "primitives/Triangle.h"
+#include "utilities/Parallel.h"
+
+/* The number of node pairs per thread which are collected before the traversal is split over the threads: */
+#define INTERSECTION_TASKS_PER_THREAD 16
+
+namespace
+{
+	/**
+	 * \brief Whether the bounds of two nodes overlap.
+	 */
+	inline bool overlap(const BVHNode& a, const BVHNode& b)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			if (a.bounds_min[i] > b.bounds_max[i] || b.bounds_min[i] > a.bounds_max[i]) return false;
+		}
+		return true;
+	}
+
+	/**
+	 * \brief Returns half of the surface area of the bounds of a node.
+	 */
+	inline float half_area(const BVHNode& node)
+	{
+		const float x = node.bounds_max[0] - node.bounds_min[0];
+		const float y = node.bounds_max[1] - node.bounds_min[1];
+		const float z = node.bounds_max[2] - node.bounds_min[2];
+		return x * y + y * z + z * x;
+	}
+
+	/**
+	 * \brief Whether two points are at exactly the same position.
+	 */
+	inline bool same_position(Vec3f a, Vec3f b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+}
+
+IntersectionQuery::IntersectionQuery(const BVH& bvh)
+	: bvh(bvh)
+{
+}
+
+std::vector<TrianglePair> IntersectionQuery::find_intersections(const BVH& other) const
+{
+	return traverse(other, false);
+}
+
+std::vector<TrianglePair> IntersectionQuery::find_self_intersections() const
+{
+	return traverse(bvh, true);
+}
+
+bool IntersectionQuery::self_intersects(const Vec3f* a, const Vec3f* b)
+{
+	// the vertex of b at the position of each vertex of a
+	int matches[3] = { -1, -1, -1 };
+	int shared = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3 && matches[i] < 0; j++)
+		{
+			if (same_position(a[i], b[j]))
+			{
+				matches[i] = j;
+				shared++;
+			}
+		}
+	}
+	if (shared == 0) return Triangle::intersects(a, b);
+	if (shared == 3) return true;
+
+	if (shared == 2)
+	{
+		// a shared edge only intersects if the triangles fold over each other
+		const int a_alone = matches[0] < 0 ? 0 : (matches[1] < 0 ? 1 : 2);
+		const int b_alone = 3 - matches[(a_alone + 1) % 3] - matches[(a_alone + 2) % 3];
+		const Vec3f normal = (a[1] - a[0]).cross(a[2] - a[0]);
+		const float length = normal.length();
+		if (std::abs(normal.dot(b[b_alone] - a[0])) > TRIANGLE_INTERSECTION_EPSILON * length * std::sqrt(length)) return false;
+		const Vec3f start = a[(a_alone + 1) % 3], edge = a[(a_alone + 2) % 3] - start;
+		return edge.cross(a[a_alone] - start).dot(edge.cross(b[b_alone] - start)) > 0.f;
+	}
+
+	const int a_shared = matches[0] >= 0 ? 0 : (matches[1] >= 0 ? 1 : 2), b_shared = matches[a_shared];
+	const Vec3f normal = (a[1] - a[0]).cross(a[2] - a[0]);
+	const float length = normal.length();
+	const float epsilon = TRIANGLE_INTERSECTION_EPSILON * length * std::sqrt(length);
+	const Vec3f b1 = b[(b_shared + 1) % 3], b2 = b[(b_shared + 2) % 3];
+	if (length > 0.f && std::abs(normal.dot(b1 - a[0])) <= epsilon && std::abs(normal.dot(b2 - a[0])) <= epsilon)
+	{
+		// near the shared vertex both triangles fill the angle between their edges, so coplanar triangles
+		// overlap exactly if these angles do, which is the case if an edge of one lies strictly inside the angle
+		// of the other or both angles are the same
+		int axis = std::abs(normal.x) > std::abs(normal.y) ? 0 : 1;
+		if (std::abs(normal.z) > std::abs(normal[axis])) axis = 2;
+		const int i = (axis + 1) % 3, j = (axis + 2) % 3;
+		const Vec3f s = a[a_shared];
+		const auto orient = [s, i, j](Vec3f p, Vec3f q)
+		{
+			return (p[i] - s[i]) * (q[j] - s[j]) - (p[j] - s[j]) * (q[i] - s[i]);
+		};
+		const auto inside = [&orient](Vec3f p, Vec3f q, Vec3f r)
+		{
+			const float angle = orient(p, q);
+			return angle != 0.f && orient(p, r) * angle > 0.f && orient(r, q) * angle > 0.f;
+		};
+		const auto same_direction = [&orient, s](Vec3f p, Vec3f q)
+		{
+			return orient(p, q) == 0.f && (p - s).dot(q - s) > 0.f;
+		};
+		const Vec3f a1 = a[(a_shared + 1) % 3], a2 = a[(a_shared + 2) % 3];
+		if (inside(a1, a2, b1) || inside(a1, a2, b2) || inside(b1, b2, a1) || inside(b1, b2, a2)) return true;
+		return (same_direction(a1, b1) && same_direction(a2, b2)) || (same_direction(a1, b2) && same_direction(a2, b1));
+	}
+
+	// a shared vertex only intersects if the opposite edge of one triangle passes through the other
+	const auto edge_hits = [](const Vec3f* t, int vertex, const Vec3f* other)
+	{
+		const Vec3f p = t[(vertex + 1) % 3], q = t[(vertex + 2) % 3];
+		float distance;
+		Barycentric barycentric;
+		return Triangle::intersect(p, q - p, other[0], other[1], other[2], distance, barycentric) && distance <= 1.f;
+	};
+	return edge_hits(a, a_shared, b) || edge_hits(b, b_shared, a);
+}
+
+std::vector<TrianglePair> IntersectionQuery::traverse(const BVH& other, bool self) const
+{
+	std::vector<TrianglePair> results;
+	if (bvh.empty() || other.empty()) return results;
+	const std::vector<BVHNode>& first_nodes = bvh.get_nodes();
+	const std::vector<BVHNode>& second_nodes = other.get_nodes();
+
+	const auto both_leaves = [&](NodePair pair)
+	{
+		return first_nodes[pair.first].is_leaf() && second_nodes[pair.second].is_leaf();
+	};
+
+	// the child pairs with overlapping bounds, splitting the larger node
+	const auto expand = [&](NodePair pair, std::vector<NodePair>& out)
+	{
+		const auto push = [&](uint32_t a, uint32_t b)
+		{
+			if (overlap(first_nodes[a], second_nodes[b])) out.push_back({ a, b });
+		};
+		const BVHNode& a = first_nodes[pair.first];
+		const BVHNode& b = second_nodes[pair.second];
+		if (self && pair.first == pair.second)
+		{
+			// a node against itself needs each pair of children only once
+			push(a.index, a.index);
+			push(a.index + 1, a.index + 1);
+			push(a.index, a.index + 1);
+			return;
+		}
+		if (!a.is_leaf() && (b.is_leaf() || half_area(a) >= half_area(b)))
+		{
+			push(a.index, pair.second);
+			push(a.index + 1, pair.second);
+		}
+		else
+		{
+			push(pair.first, b.index);
+			push(pair.first, b.index + 1);
+		}
+	};
+
+	const auto test_leaves = [&](NodePair pair, std::vector<TrianglePair>& out)
+	{
+		const BVHNode& a = first_nodes[pair.first];
+		const BVHNode& b = second_nodes[pair.second];
+		const bool same_leaf = self && pair.first == pair.second;
+		for (uint32_t i = a.index; i < a.index + a.count; i++)
+		{
+			for (uint32_t j = same_leaf ? i + 1 : b.index; j < b.index + b.count; j++)
+			{
+				const Vec3f* va = bvh.get_vertices(i);
+				const Vec3f* vb = other.get_vertices(j);
+				if (!(self ? self_intersects(va, vb) : Triangle::intersects(va, vb))) continue;
+				const uint32_t x = bvh.get_triangle_id(i), y = other.get_triangle_id(j);
+				out.push_back(self && x > y ? TrianglePair{ y, x } : TrianglePair{ x, y });
+			}
+		}
+	};
+
+	// breadth first until there are enough pairs for all threads
+	std::vector<NodePair> tasks, next;
+	if (overlap(first_nodes[0], second_nodes[0])) tasks.push_back({ 0, 0 });
+	const size_t target = static_cast<size_t>(Utilities::thread_count()) * INTERSECTION_TASKS_PER_THREAD;
+	while (tasks.size() < target)
+	{
+		bool expanded = false;
+		next.clear();
+		for (const NodePair& pair : tasks)
+		{
+			if (both_leaves(pair))
+			{
+				next.push_back(pair);
+				continue;
+			}
+			expand(pair, next);
+			expanded = true;
+		}
+		tasks.swap(next);
+		if (!expanded) break;
+	}
+
+	// each thread collects its pairs in its own buffer
+	std::vector<std::vector<TrianglePair>> buffers(Utilities::thread_count());
+	Utilities::parallel_for(tasks.size(), [&](size_t begin, size_t end, unsigned int thread)
+	{
+		std::vector<NodePair> stack;
+		std::vector<TrianglePair>& buffer = buffers[thread];
+		for (size_t t = begin; t < end; t++)
+		{
+			stack.push_back(tasks[t]);
+			while (!stack.empty())
+			{
+				const NodePair pair = stack.back();
+				stack.pop_back();
+				if (both_leaves(pair))
+					test_leaves(pair, buffer);
+				else
+					expand(pair, stack);
+			}
+		}
+	}, 1);
+
+	for (const std::vector<TrianglePair>& buffer : buffers)
+		results.insert(results.end(), buffer.begin(), buffer.end());
+	std::sort(results.begin(), results.end(), [](const TrianglePair& a, const TrianglePair& b)
+	{
+		return a.first != b.first ? a.first < b.first : a.second < b.second;
+	});
+	return results;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry/BVH.h"
+
+/**
+ * \brief A pair of intersecting triangles.
+ */
+struct TrianglePair
+{
+	/**
+	 * \brief The id of the triangle of the first mesh. (the smaller id for self-intersections)
+	 */
+	uint32_t first;
+
+	/**
+	 * \brief The id of the triangle of the second mesh.
+	 */
+	uint32_t second;
+};
+
+/**
+ * \brief Finds intersecting triangles within one or between two bounding volume hierarchies.
+ * Both hierarchies are traversed together, only descending into pairs of nodes whose bounds overlap. The pairs near
+ * the roots are handed out to all threads, which collect their results in their own buffers.
+ */
+class IntersectionQuery
+{
+public:
+	/**
+	 * \brief The constructor.
+	 * \param bvh The bounding volume hierarchy. (Has to outlive the query)
+	 */
+	explicit IntersectionQuery(const BVH& bvh);
+
+	/**
+	 * \brief Finds the intersecting triangles of two meshes.
+	 * \param other The hierarchy of the other mesh.
+	 * \return The intersecting pairs. (sorted)
+	 */
+	std::vector<TrianglePair> find_intersections(const BVH& other) const;
+
+	/**
+	 * \brief Finds the self-intersections of the mesh. Triangles which share vertex positions only count if they
+	 * also intersect elsewhere: an edge of one passes through the other or they fold over each other.
+	 * \return The intersecting pairs. (sorted)
+	 */
+	std::vector<TrianglePair> find_self_intersections() const;
+
+	/**
+	 * \brief Whether two triangles of the same mesh intersect, ignoring the vertex positions they share.
+	 * \param a The vertices of the first triangle.
+	 * \param b The vertices of the second triangle.
+	 * \return Whether the triangles intersect.
+	 */
+	static bool self_intersects(const Vec3f* a, const Vec3f* b);
+
+private:
+	/**
+	 * \brief A pair of nodes whose bounds overlap.
+	 */
+	struct NodePair
+	{
+		uint32_t first, second;
+	};
+
+	/**
+	 * \brief Traverses both hierarchies together.
+	 * \param other The other hierarchy. (the same one for self-intersections)
+	 * \param self Whether the self-intersections are searched.
+	 * \return The intersecting pairs. (sorted)
+	 */
+	std::vector<TrianglePair> traverse(const BVH& other, bool self) const;
+
+	/**
+	 * \brief The bounding volume hierarchy.
+	 */
+	const BVH& bvh;
+};
@@ -0,0 +1,194 @@
+#include "IsolineExtractor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "utilities/Parallel.h"
+
+IsolineExtractor::IsolineExtractor(const HalfEdgeMesh& mesh, const std::vector<float>& values, const std::vector<float>& levels)
+{
+	if (values.size() != mesh.vertex_count())
+		throw std::invalid_argument("'IsolineExtractor' should only be called with one value per vertex.");
+	if (!std::is_sorted(levels.begin(), levels.end()))
+		throw std::invalid_argument("'IsolineExtractor' should only be called with ascending levels.");
+	const uint32_t face_count = mesh.face_count();
+	const uint32_t level_count = static_cast<uint32_t>(levels.size());
+
+	// the levels which cross a face are min < level <= max, which is the range [first, last)
+	std::vector<uint32_t> first_levels(face_count), last_levels(face_count);
+	Utilities::parallel_for(face_count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t face = begin; face < end; face++)
+		{
+			const uint32_t h = HalfEdgeMesh::half_edge(static_cast<uint32_t>(face));
+			const float a = values[mesh.origin(h)], b = values[mesh.origin(h + 1)], c = values[mesh.origin(h + 2)];
+			const float min = std::min({ a, b, c }), max = std::max({ a, b, c });
+			if (std::isnan(a) || std::isnan(b) || std::isnan(c))
+			{
+				first_levels[face] = last_levels[face] = 0;
+				continue;
+			}
+			first_levels[face] = static_cast<uint32_t>(std::upper_bound(levels.begin(), levels.end(), min) - levels.begin());
+			last_levels[face] = static_cast<uint32_t>(std::upper_bound(levels.begin(), levels.end(), max) - levels.begin());
+		}
+	}, 4096);
+
+	// the crossed faces of each level in ascending order (counting sort)
+	std::vector<uint32_t> level_begins(level_count + 1, 0);
+	for (uint32_t face = 0; face < face_count; face++)
+	{
+		if (first_levels[face] < last_levels[face])
+		{
+			level_begins[first_levels[face]]++;
+			level_begins[last_levels[face]]--;
+		}
+	}
+	uint32_t crossing = 0, total = 0;
+	for (uint32_t level = 0; level < level_count; level++)
+	{
+		crossing += level_begins[level];
+		level_begins[level] = total;
+		total += crossing;
+	}
+	level_begins[level_count] = total;
+	std::vector<uint32_t> level_faces(total);
+	std::vector<uint32_t> cursors(level_begins.begin(), level_begins.end() - 1);
+	for (uint32_t face = 0; face < face_count; face++)
+	{
+		for (uint32_t level = first_levels[face]; level < last_levels[face]; level++)
+			level_faces[cursors[level]++] = face;
+	}
+
+	// stitches the polylines of each level
+	std::vector<std::vector<Isoline>> level_isolines(level_count);
+	std::vector<std::vector<Vec3f>> level_points(level_count);
+	Utilities::parallel_for(level_count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t level = begin; level < end; level++)
+		{
+			const float value = levels[level];
+			const uint32_t* faces = level_faces.data() + level_begins[level];
+			const uint32_t count = level_begins[level + 1] - level_begins[level];
+			std::vector<uint8_t> visited(count, 0);
+			std::vector<Isoline>& polylines = level_isolines[level];
+			std::vector<Vec3f>& polyline_points = level_points[level];
+
+			// the half-edges where the isoline enters and leaves a face, from above to below and the other way round
+			const auto crossed = [&](uint32_t face, uint32_t& entry, uint32_t& exit)
+			{
+				for (uint32_t h = HalfEdgeMesh::half_edge(face); h < HalfEdgeMesh::half_edge(face) + 3; h++)
+				{
+					const bool origin_above = values[mesh.origin(h)] >= value, target_above = values[mesh.target(h)] >= value;
+					if (origin_above && !target_above)
+						entry = h;
+					else if (!origin_above && target_above)
+						exit = h;
+				}
+			};
+			// the crossing of an edge, interpolated from its smaller vertex so both half-edges give the same point
+			const auto crossing_point = [&](uint32_t h)
+			{
+				uint32_t a = mesh.origin(h), b = mesh.target(h);
+				if (a > b)
+					std::swap(a, b);
+				const float t = (value - values[a]) / (values[b] - values[a]);
+				return mesh.position(a) + (mesh.position(b) - mesh.position(a)) * t;
+			};
+			const auto visit = [&](uint32_t face) -> bool
+			{
+				const uint32_t i = static_cast<uint32_t>(std::lower_bound(faces, faces + count, face) - faces);
+				if (visited[i])
+					return false;
+				visited[i] = 1;
+				return true;
+			};
+			const auto walk = [&](uint32_t start)
+			{
+				Isoline isoline;
+				isoline.level = static_cast<uint32_t>(level);
+				isoline.begin = static_cast<uint32_t>(polyline_points.size());
+				isoline.closed = false;
+				uint32_t entry = HalfEdgeMesh::INVALID, exit = HalfEdgeMesh::INVALID;
+				crossed(start, entry, exit);
+				polyline_points.push_back(crossing_point(entry));
+				uint32_t face = start;
+				while (true)
+				{
+					polyline_points.push_back(crossing_point(exit));
+					const uint32_t twin = mesh.twin(exit);
+					if (twin == HalfEdgeMesh::INVALID)
+						break;
+					face = HalfEdgeMesh::face(twin);
+					if (face == start)
+					{
+						// the last point is the first one again
+						polyline_points.pop_back();
+						isoline.closed = true;
+						break;
+					}
+					if (!visit(face))
+						break;
+					crossed(face, entry, exit);
+				}
+				isoline.end = static_cast<uint32_t>(polyline_points.size());
+				polylines.push_back(isoline);
+			};
+
+			// open isolines start on the boundary, all remaining ones are closed
+			for (uint32_t i = 0; i < count; i++)
+			{
+				uint32_t entry = HalfEdgeMesh::INVALID, exit = HalfEdgeMesh::INVALID;
+				crossed(faces[i], entry, exit);
+				if (mesh.twin(entry) == HalfEdgeMesh::INVALID && visit(faces[i]))
+					walk(faces[i]);
+			}
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (visit(faces[i]))
+					walk(faces[i]);
+			}
+		}
+	}, 1);
+
+	// concatenates the levels
+	size_t isoline_count = 0, point_count = 0;
+	for (uint32_t level = 0; level < level_count; level++)
+	{
+		isoline_count += level_isolines[level].size();
+		point_count += level_points[level].size();
+	}
+	isolines.reserve(isoline_count);
+	points.reserve(point_count);
+	for (uint32_t level = 0; level < level_count; level++)
+	{
+		const uint32_t offset = static_cast<uint32_t>(points.size());
+		for (Isoline isoline : level_isolines[level])
+		{
+			isoline.begin += offset;
+			isoline.end += offset;
+			isolines.push_back(isoline);
+		}
+		points.insert(points.end(), level_points[level].begin(), level_points[level].end());
+	}
+}
+
+std::vector<float> IsolineExtractor::uniform_levels(float start, float interval, float end)
+{
+	if (!(interval > 0.f))
+		throw std::invalid_argument("'IsolineExtractor::uniform_levels' should only be called with a positive interval.");
+	std::vector<float> levels;
+	for (uint32_t i = 0; start + interval * i <= end; i++)
+		levels.push_back(start + interval * i);
+	return levels;
+}
+
+const std::vector<Isoline>& IsolineExtractor::get_isolines() const
+{
+	return isolines;
+}
+
+const std::vector<Vec3f>& IsolineExtractor::get_points() const
+{
+	return points;
+}
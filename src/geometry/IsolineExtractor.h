@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry/HalfEdgeMesh.h"
+#include "math/Vec3f.h"
+
+/**
+ * \brief A polyline where a scalar field on a mesh equals a level.
+ */
+struct Isoline
+{
+	/**
+	 * \brief The index of the level.
+	 */
+	uint32_t level;
+
+	/**
+	 * \brief The range of the points in 'IsolineExtractor::get_points'.
+	 */
+	uint32_t begin, end;
+
+	/**
+	 * \brief Whether the last point connects to the first one.
+	 */
+	bool closed;
+};
+
+/**
+ * \brief Extracts the isolines of a scalar field on the vertices of a mesh with marching triangles.
+ * The values are linearly interpolated along the edges, so each isoline crosses an edge at most once per level.
+ * Values which equal a level count as above it, so each face is crossed by a level twice or not at all and the
+ * isolines never branch. A parallel pass over the faces collects the crossed faces of each level, then the
+ * polylines of the levels are stitched in parallel by walking from the face where an isoline leaves through the
+ * twin half-edge into the next one. Isolines keep the values below the level on their left.
+ */
+class IsolineExtractor
+{
+public:
+	/**
+	 * \brief The constructor. Extracts the isolines on all threads.
+	 * \param mesh The mesh.
+	 * \param values The scalar values. (one per vertex)
+	 * \param levels The levels. (ascending)
+	 */
+	IsolineExtractor(const HalfEdgeMesh& mesh, const std::vector<float>& values, const std::vector<float>& levels);
+
+	/**
+	 * \brief Returns evenly spaced levels, like the isoline settings of the barycentric coordinates.
+	 * \param start The first level.
+	 * \param interval The distance between the levels. (positive)
+	 * \param end The largest level.
+	 * \return The levels.
+	 */
+	static std::vector<float> uniform_levels(float start, float interval, float end);
+
+	/**
+	 * \brief Returns the isolines, ordered by level.
+	 * \return The isolines.
+	 */
+	const std::vector<Isoline>& get_isolines() const;
+
+	/**
+	 * \brief Returns the points of all isolines.
+	 * \return The points.
+	 */
+	const std::vector<Vec3f>& get_points() const;
+
+private:
+	/**
+	 * \brief The isolines.
+	 */
+	std::vector<Isoline> isolines;
+
+	/**
+	 * \brief The points of all isolines.
+	 */
+	std::vector<Vec3f> points;
+};
@@ -0,0 +1,201 @@
+#include "PNTriangles.h"
+
+#include <cmath>
+
+#include "utilities/Parallel.h"
+
+namespace
+{
+	/**
+	 * \brief Returns a vector scaled to unit length. (or the fallback for vectors of zero length)
+	 */
+	inline Vec3f normalized(Vec3f v, Vec3f fallback)
+	{
+		const float length = v.length();
+		return length > 0.f ? v * (1.f / length) : fallback;
+	}
+
+	/**
+	 * \brief Returns the edge control point next to the vertex p, which is the point a third along the edge to q
+	 * projected into the tangent plane of p.
+	 */
+	inline Vec3f edge_point(Vec3f p, Vec3f q, Vec3f normal)
+	{
+		return (p * 2.f + q - normal * (q - p).dot(normal)) * (1.f / 3.f);
+	}
+
+	/**
+	 * \brief Returns the normal control point of the edge from p to q, which is the average normal reflected at
+	 * the plane perpendicular to the edge.
+	 */
+	inline Vec3f edge_normal(Vec3f p, Vec3f q, Vec3f np, Vec3f nq)
+	{
+		const Vec3f edge = q - p;
+		const float squared_length = edge.dot(edge);
+		const float v = squared_length > 0.f ? 2.f * edge.dot(np + nq) / squared_length : 0.f;
+		return normalized(np + nq - edge * v, np);
+	}
+
+	/**
+	 * \brief Computes the cubic Bernstein polynomials in the order of 'PNControlNet::points'.
+	 */
+	inline void cubic_basis(float w, float u, float v, float* basis)
+	{
+		basis[0] = w * w * w;
+		basis[1] = u * u * u;
+		basis[2] = v * v * v;
+		basis[3] = 3.f * w * w * u;
+		basis[4] = 3.f * w * u * u;
+		basis[5] = 3.f * u * u * v;
+		basis[6] = 3.f * u * v * v;
+		basis[7] = 3.f * w * v * v;
+		basis[8] = 3.f * w * w * v;
+		basis[9] = 6.f * w * u * v;
+	}
+
+	/**
+	 * \brief Computes the quadratic Bernstein polynomials in the order of 'PNControlNet::normals'.
+	 * (the mixed terms without the factor 2, like the normal field of the PN triangle paper)
+	 */
+	inline void quadratic_basis(float w, float u, float v, float* basis)
+	{
+		basis[0] = w * w;
+		basis[1] = u * u;
+		basis[2] = v * v;
+		basis[3] = w * u;
+		basis[4] = u * v;
+		basis[5] = w * v;
+	}
+}
+
+PNTriangles::PNTriangles(const std::vector<Triangle>& triangles)
+	: nets(triangles.size())
+{
+	Utilities::parallel_for(triangles.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const Vertex* vertices = triangles[i].vertices;
+			Vec3f p[3], n[3];
+			for (int corner = 0; corner < 3; corner++)
+				p[corner] = Vec3f(vertices[corner].position);
+			const Vec3f face_normal = normalized((p[1] - p[0]).cross(p[2] - p[0]), Vec3f(0.f, 0.f, 0.f));
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const Vec4f& normal = vertices[corner].normal;
+				n[corner] = normalized(Vec3f(normal.x, normal.y, normal.z), face_normal);
+			}
+
+			// the edge points around the triangle and the center, which is moved away from the flat triangle
+			// by half of the distance between the average edge point and the centroid
+			PNControlNet& net = nets[i];
+			net.points[0] = p[0];
+			net.points[1] = p[1];
+			net.points[2] = p[2];
+			net.points[3] = edge_point(p[0], p[1], n[0]);
+			net.points[4] = edge_point(p[1], p[0], n[1]);
+			net.points[5] = edge_point(p[1], p[2], n[1]);
+			net.points[6] = edge_point(p[2], p[1], n[2]);
+			net.points[7] = edge_point(p[2], p[0], n[2]);
+			net.points[8] = edge_point(p[0], p[2], n[0]);
+			Vec3f edge_average(0.f, 0.f, 0.f);
+			for (int k = 3; k < 9; k++)
+				edge_average = edge_average + net.points[k];
+			edge_average = edge_average * (1.f / 6.f);
+			const Vec3f centroid = (p[0] + p[1] + p[2]) * (1.f / 3.f);
+			net.points[9] = edge_average + (edge_average - centroid) * 0.5f;
+
+			net.normals[0] = n[0];
+			net.normals[1] = n[1];
+			net.normals[2] = n[2];
+			net.normals[3] = edge_normal(p[0], p[1], n[0], n[1]);
+			net.normals[4] = edge_normal(p[1], p[2], n[1], n[2]);
+			net.normals[5] = edge_normal(p[2], p[0], n[2], n[0]);
+		}
+	}, 4096);
+}
+
+const std::vector<PNControlNet>& PNTriangles::get_control_nets() const
+{
+	return nets;
+}
+
+Vec3f PNTriangles::position(uint32_t triangle, Barycentric barycentric) const
+{
+	float basis[10];
+	cubic_basis(barycentric.alpha, barycentric.beta, barycentric.gamma, basis);
+	const PNControlNet& net = nets[triangle];
+	Vec3f result(0.f, 0.f, 0.f);
+	for (int k = 0; k < 10; k++)
+		result = result + net.points[k] * basis[k];
+	return result;
+}
+
+Vec3f PNTriangles::normal(uint32_t triangle, Barycentric barycentric) const
+{
+	float basis[6];
+	quadratic_basis(barycentric.alpha, barycentric.beta, barycentric.gamma, basis);
+	const PNControlNet& net = nets[triangle];
+	Vec3f result(0.f, 0.f, 0.f);
+	for (int k = 0; k < 6; k++)
+		result = result + net.normals[k] * basis[k];
+	return normalized(result, net.normals[0]);
+}
+
+template <typename Locations>
+void PNTriangles::evaluate_range(const Locations& locations, size_t begin, size_t end, Vec3f* positions, Vec3f* normals) const
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		uint32_t triangle;
+		Barycentric barycentric;
+		if (!locations(i, triangle, barycentric))
+			continue;
+		if (positions)
+			positions[i] = position(triangle, barycentric);
+		if (normals)
+			normals[i] = normal(triangle, barycentric);
+	}
+}
+
+void PNTriangles::evaluate(const uint32_t* triangles, const Barycentric* barycentrics, size_t count, Vec3f* positions, Vec3f* normals) const
+{
+	const auto locations = [triangles, barycentrics](size_t i, uint32_t& triangle, Barycentric& barycentric)
+	{
+		triangle = triangles[i];
+		barycentric = barycentrics[i];
+		return true;
+	};
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		evaluate_range(locations, begin, end, positions, normals);
+	}, 4096);
+}
+
+void PNTriangles::evaluate(const SurfaceSample* samples, size_t count, Vec3f* positions, Vec3f* normals) const
+{
+	const auto locations = [samples](size_t i, uint32_t& triangle, Barycentric& barycentric)
+	{
+		triangle = samples[i].triangle;
+		barycentric = samples[i].barycentric;
+		return true;
+	};
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		evaluate_range(locations, begin, end, positions, normals);
+	}, 4096);
+}
+
+void PNTriangles::evaluate(const ClosestPointResult* results, size_t count, Vec3f* positions, Vec3f* normals) const
+{
+	const auto locations = [results](size_t i, uint32_t& triangle, Barycentric& barycentric)
+	{
+		triangle = results[i].triangle;
+		barycentric = results[i].barycentric;
+		return triangle != ClosestPointQuery::NO_TRIANGLE;
+	};
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		evaluate_range(locations, begin, end, positions, normals);
+	}, 4096);
+}
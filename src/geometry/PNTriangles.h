@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geometry/ClosestPointQuery.h"
+#include "geometry/SurfaceSampler.h"
+#include "math/Vec3f.h"
+#include "primitives/Barycentric.h"
+#include "primitives/Triangle.h"
+
+/**
+ * \brief The control net of a PN triangle: a cubic Bezier triangle for the position and a quadratic one for the
+ * normal. (192 bytes)
+ */
+struct PNControlNet
+{
+	/**
+	 * \brief The position control points b300, b030, b003, b210, b120, b021, b012, b102, b201 and b111.
+	 */
+	Vec3f points[10];
+
+	/**
+	 * \brief The normal control points n200, n020, n002, n110, n011 and n101.
+	 */
+	Vec3f normals[6];
+};
+
+/**
+ * \brief Curved PN triangles over a triangle mesh. (Vlachos et al., Curved PN Triangles)
+ * Each triangle gets a cubic patch through its vertices which is tangent to their normals, so the surface is
+ * smooth wherever neighbouring triangles share the vertex normals, and flat triangles stay flat.
+ * The patches only depend on their own triangle, so they are built in parallel, and a point on the surface is
+ * evaluated from its barycentric coordinates without tessellating the mesh. The barycentric coordinates
+ * (alpha, beta, gamma) weight the vertices like 'Triangle::interpolate', so the results of 'ClosestPointQuery'
+ * or 'SurfaceSampler' on the flat triangles can be moved onto the curved surface.
+ * A point reads the 192 bytes of one control net, so batches which are sorted by triangle evaluate faster.
+ */
+class PNTriangles
+{
+public:
+	/**
+	 * \brief The constructor. Builds the control nets on all threads.
+	 * \param triangles The triangles. (vertex normals of zero length are replaced by the face normal)
+	 */
+	explicit PNTriangles(const std::vector<Triangle>& triangles);
+
+	/**
+	 * \brief Returns the control nets.
+	 * \return The control nets. (one per triangle)
+	 */
+	const std::vector<PNControlNet>& get_control_nets() const;
+
+	/**
+	 * \brief Evaluates the position on a patch.
+	 * \param triangle The id of the triangle.
+	 * \param barycentric The barycentric coordinates.
+	 * \return The position.
+	 */
+	Vec3f position(uint32_t triangle, Barycentric barycentric) const;
+
+	/**
+	 * \brief Evaluates the normal on a patch.
+	 * \param triangle The id of the triangle.
+	 * \param barycentric The barycentric coordinates.
+	 * \return The unit normal.
+	 */
+	Vec3f normal(uint32_t triangle, Barycentric barycentric) const;
+
+	/**
+	 * \brief Evaluates the positions and normals of many points on all threads.
+	 * \param triangles The ids of the triangles.
+	 * \param barycentrics The barycentric coordinates.
+	 * \param count The number of points.
+	 * \param positions The positions. (or nullptr)
+	 * \param normals The unit normals. (or nullptr)
+	 */
+	void evaluate(const uint32_t* triangles, const Barycentric* barycentrics, size_t count, Vec3f* positions, Vec3f* normals = nullptr) const;
+
+	/**
+	 * \brief Evaluates the positions and normals of surface samples on all threads.
+	 * \param samples The samples. (e.g. of 'SurfaceSampler::sample')
+	 * \param count The number of samples.
+	 * \param positions The positions. (or nullptr)
+	 * \param normals The unit normals. (or nullptr)
+	 */
+	void evaluate(const SurfaceSample* samples, size_t count, Vec3f* positions, Vec3f* normals = nullptr) const;
+
+	/**
+	 * \brief Evaluates the positions and normals of closest points on all threads.
+	 * Results without a triangle leave their position and normal unchanged.
+	 * \param results The closest points. (e.g. of 'ClosestPointQuery::find')
+	 * \param count The number of closest points.
+	 * \param positions The positions. (or nullptr)
+	 * \param normals The unit normals. (or nullptr)
+	 */
+	void evaluate(const ClosestPointResult* results, size_t count, Vec3f* positions, Vec3f* normals = nullptr) const;
+
+private:
+	/**
+	 * \brief Evaluates a range of points.
+	 * \param locations Returns the triangle and the barycentric coordinates of a point.
+	 * \param begin The first point.
+	 * \param end The point after the last one.
+	 * \param positions The positions. (or nullptr)
+	 * \param normals The unit normals. (or nullptr)
+	 */
+	template <typename Locations>
+	void evaluate_range(const Locations& locations, size_t begin, size_t end, Vec3f* positions, Vec3f* normals) const;
+
+	/**
+	 * \brief The control nets.
+	 */
+	std::vector<PNControlNet> nets;
+};
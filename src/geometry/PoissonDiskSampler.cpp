@@ -0,0 +1,316 @@
+#include "PoissonDiskSampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "math/Morton.h"
+#include "utilities/Parallel.h"
+#include "utilities/RadixSort.h"
+#include "utilities/Random.h"
+
+/* The number of bits per axis of the cell coordinates: */
+#define POISSON_DISK_CELL_BITS 20
+
+/* The edge length of the cells in largest radii: (larger cells need fewer neighbour lookups, but test more samples) */
+#define POISSON_DISK_CELL_RADII 2.f
+
+namespace
+{
+	/**
+	 * \brief A hash table from the Morton codes of the cells to their ids. (open addressing with linear probing)
+	 * The neighbour lookups dominate the dart throwing, where 'std::unordered_map' spends most time in the modulo.
+	 */
+	class CellTable
+	{
+	public:
+		/**
+		 * \brief The constructor.
+		 * \param count The number of cells.
+		 */
+		explicit CellTable(size_t count)
+		{
+			size_t capacity = 1;
+			while (capacity < 2 * count) capacity <<= 1;
+			mask = capacity - 1;
+			codes.assign(capacity, EMPTY);
+			ids.resize(capacity);
+		}
+
+		/**
+		 * \brief Adds a cell.
+		 * \param code The Morton code of the cell.
+		 * \param id The id of the cell.
+		 */
+		void insert(uint64_t code, uint32_t id)
+		{
+			size_t slot = Utilities::mix_bits(code) & mask;
+			while (codes[slot] != EMPTY) slot = (slot + 1) & mask;
+			codes[slot] = code;
+			ids[slot] = id;
+		}
+
+		/**
+		 * \brief Finds a cell.
+		 * \param code The Morton code of the cell.
+		 * \return The id of the cell. (0xFFFFFFFF if there is no such cell)
+		 */
+		uint32_t find(uint64_t code) const
+		{
+			for (size_t slot = Utilities::mix_bits(code) & mask; codes[slot] != EMPTY; slot = (slot + 1) & mask)
+			{
+				if (codes[slot] == code)
+					return ids[slot];
+			}
+			return 0xFFFFFFFF;
+		}
+
+	private:
+		/**
+		 * \brief The code of empty slots, which no cell has since the codes have 60 bits.
+		 */
+		static const uint64_t EMPTY = ~0ull;
+
+		/**
+		 * \brief The Morton codes of the slots.
+		 */
+		std::vector<uint64_t> codes;
+
+		/**
+		 * \brief The cell ids of the slots.
+		 */
+		std::vector<uint32_t> ids;
+
+		/**
+		 * \brief The number of slots - 1.
+		 */
+		size_t mask;
+	};
+
+	const uint64_t CellTable::EMPTY;
+}
+
+PoissonDiskSampler::PoissonDiskSampler(const std::vector<Triangle>& triangles, float radius,
+	const std::vector<float>& densities, uint64_t seed)
+	: triangles(triangles)
+{
+	if (!(radius > 0.f))
+		throw std::invalid_argument("'PoissonDiskSampler' should only be called with a positive radius.");
+	if (!densities.empty() && densities.size() != 3 * triangles.size())
+		throw std::invalid_argument("'PoissonDiskSampler' should only be called with 3 densities per triangle.");
+	if (triangles.empty())
+		return;
+
+	const SurfaceSampler sampler(triangles, seed);
+	const double candidate_count = std::ceil(POISSON_DISK_CANDIDATES * sampler.get_area() / (static_cast<double>(radius) * radius));
+	if (candidate_count >= static_cast<double>(0xFFFFFFFFu))
+		throw std::invalid_argument("'PoissonDiskSampler' should only be called with a radius that gives less than 2^32 candidates.");
+	const size_t count = static_cast<size_t>(candidate_count);
+	std::vector<SurfaceSample> candidates(count);
+	sampler.sample(0, count, candidates.data());
+
+	// keeps each candidate with the probability of its density (radius 0 marks the others)
+	const uint64_t stream = Utilities::random_stream(~seed);
+	std::vector<Vec3f> positions(count);
+	std::vector<float> radii(count);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const Barycentric& barycentric = candidates[i].barycentric;
+			const Vertex* vertices = triangles[candidates[i].triangle].vertices;
+			positions[i] = Vec3f(vertices[0].position) * barycentric.alpha + Vec3f(vertices[1].position) * barycentric.beta
+				+ Vec3f(vertices[2].position) * barycentric.gamma;
+
+			float density = 1.f;
+			if (!densities.empty())
+			{
+				const float* corners = &densities[3 * static_cast<size_t>(candidates[i].triangle)];
+				density = std::min(1.f, corners[0] * barycentric.alpha + corners[1] * barycentric.beta + corners[2] * barycentric.gamma);
+			}
+			const bool kept = Utilities::to_unit_float(Utilities::random_bits(stream, i)) < density;
+			radii[i] = kept ? radius / std::sqrt(std::max(density, POISSON_DISK_MIN_DENSITY)) : 0.f;
+		}
+	}, 16384);
+
+	// the cells are at least as large as the largest radius, so only the neighbouring cells can conflict
+	Vec3f min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+	Vec3f max = -min;
+	float max_radius = 0.f;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (radii[i] == 0.f)
+			continue;
+		min = Vec3f::min(min, positions[i]);
+		max = Vec3f::max(max, positions[i]);
+		max_radius = std::max(max_radius, radii[i]);
+	}
+	if (max_radius == 0.f)
+		return;
+	const float max_extent = std::max(max.x - min.x, std::max(max.y - min.y, max.z - min.z));
+	const float cell_size = std::max(POISSON_DISK_CELL_RADII * max_radius,
+		1.01f * max_extent / static_cast<float>(1 << POISSON_DISK_CELL_BITS));
+	const float scale = 1.f / cell_size;
+	int cell_bits = 1;
+	while (cell_bits < POISSON_DISK_CELL_BITS && static_cast<float>(1 << cell_bits) <= max_extent * scale)
+		cell_bits++;
+
+	const auto cell_of = [&](Vec3f position, uint32_t cell[3])
+	{
+		for (int axis = 0; axis < 3; axis++)
+			cell[axis] = Morton::quantize(position[axis], min[axis], scale, POISSON_DISK_CELL_BITS);
+	};
+
+	// sorts the kept candidates along the Morton curve of the cells, each cell keeps the random order of its candidates
+	std::vector<uint64_t> keys;
+	std::vector<uint32_t> ids;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (radii[i] == 0.f)
+			continue;
+		uint32_t cell[3];
+		cell_of(positions[i], cell);
+		keys.push_back(Morton::encode(cell[0], cell[1], cell[2]));
+		ids.push_back(i);
+	}
+	Utilities::radix_sort(keys, ids, 0, 3 * cell_bits);
+
+	// the phase of a cell are the parities of its coordinates, which are the lowest 3 bits of the Morton code
+	std::vector<uint32_t> cell_begins;
+	std::vector<uint32_t> phases[8];
+	for (uint32_t i = 0; i < keys.size(); i++)
+	{
+		if (i > 0 && keys[i] == keys[i - 1])
+			continue;
+		phases[keys[i] & 7].push_back(static_cast<uint32_t>(cell_begins.size()));
+		cell_begins.push_back(i);
+	}
+	const uint32_t cell_count = static_cast<uint32_t>(cell_begins.size());
+	cell_begins.push_back(static_cast<uint32_t>(keys.size()));
+	CellTable cells(cell_count);
+	for (uint32_t cell = 0; cell < cell_count; cell++)
+		cells.insert(keys[cell_begins[cell]], cell);
+
+	// the accepted darts of each cell are moved to its front
+	std::vector<Vec3f> cell_positions(keys.size());
+	std::vector<float> cell_radii(keys.size());
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		cell_positions[i] = positions[ids[i]];
+		cell_radii[i] = radii[ids[i]];
+	}
+	std::vector<uint32_t> accepted(cell_count, 0);
+
+	for (int phase = 0; phase < 8; phase++)
+	{
+		const std::vector<uint32_t>& phase_cells = phases[phase];
+		Utilities::parallel_for(phase_cells.size(), [&](size_t begin, size_t end, unsigned int)
+		{
+			uint32_t neighbours[27];
+			for (size_t i = begin; i < end; i++)
+			{
+				// the cell itself comes first, since most darts are rejected by samples in their own cell
+				const uint32_t cell = phase_cells[i];
+				uint32_t coordinates[3];
+				cell_of(cell_positions[cell_begins[cell]], coordinates);
+				int neighbour_count = 0;
+				neighbours[neighbour_count++] = cell;
+				for (int dz = -1; dz <= 1; dz++)
+				{
+					for (int dy = -1; dy <= 1; dy++)
+					{
+						for (int dx = -1; dx <= 1; dx++)
+						{
+							const uint32_t x = coordinates[0] + dx, y = coordinates[1] + dy, z = coordinates[2] + dz;
+							if ((dx == 0 && dy == 0 && dz == 0) || (x | y | z) >> POISSON_DISK_CELL_BITS)
+								continue;
+							const uint32_t neighbour = cells.find(Morton::encode(x, y, z));
+							if (neighbour != 0xFFFFFFFF)
+								neighbours[neighbour_count++] = neighbour;
+						}
+					}
+				}
+
+				// throws the darts, the neighbours are in other phases and the cell itself is only changed here
+				const uint32_t first = cell_begins[cell];
+				for (uint32_t dart = first; dart < cell_begins[cell + 1]; dart++)
+				{
+					const Vec3f position = cell_positions[dart];
+					const float dart_radius = cell_radii[dart];
+					bool free = true;
+					for (int n = 0; n < neighbour_count && free; n++)
+					{
+						const uint32_t other_first = cell_begins[neighbours[n]];
+						for (uint32_t other = other_first; other < other_first + accepted[neighbours[n]]; other++)
+						{
+							const Vec3f d = cell_positions[other] - position;
+							const float distance = std::min(dart_radius, cell_radii[other]);
+							if (d.dot(d) < distance * distance)
+							{
+								free = false;
+								break;
+							}
+						}
+					}
+					if (!free)
+						continue;
+					const uint32_t slot = first + accepted[cell]++;
+					cell_positions[slot] = position;
+					cell_radii[slot] = dart_radius;
+					ids[slot] = ids[dart];
+				}
+			}
+		}, 16);
+	}
+
+	// the samples in the order of their candidates
+	std::vector<uint32_t> sample_ids;
+	for (uint32_t cell = 0; cell < cell_count; cell++)
+		sample_ids.insert(sample_ids.end(), ids.begin() + cell_begins[cell], ids.begin() + cell_begins[cell] + accepted[cell]);
+	std::sort(sample_ids.begin(), sample_ids.end());
+	samples.reserve(sample_ids.size());
+	for (uint32_t id : sample_ids)
+		samples.push_back(candidates[id]);
+}
+
+std::vector<float> PoissonDiskSampler::densities_from_colors(const std::vector<Triangle>& triangles)
+{
+	std::vector<float> densities(3 * triangles.size());
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			const Vec4f& color = triangles[i].vertices[corner].color;
+			densities[3 * i + corner] = 0.2126f * color.x + 0.7152f * color.y + 0.0722f * color.z;
+		}
+	}
+	return densities;
+}
+
+const std::vector<SurfaceSample>& PoissonDiskSampler::get_samples() const
+{
+	return samples;
+}
+
+std::vector<Vec3f> PoissonDiskSampler::get_positions() const
+{
+	std::vector<Vec3f> positions(samples.size());
+	Utilities::parallel_for(samples.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+			positions[i] = Vec3f(triangles[samples[i].triangle].interpolate(samples[i].barycentric).position);
+	}, 16384);
+	return positions;
+}
+
+std::vector<Vertex> PoissonDiskSampler::get_vertices() const
+{
+	std::vector<Vertex> vertices(samples.size());
+	Utilities::parallel_for(samples.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+			vertices[i] = triangles[samples[i].triangle].interpolate(samples[i].barycentric);
+	}, 16384);
+	return vertices;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "SurfaceSampler.h"
+#include "math/Vec3f.h"
+#include "primitives/Triangle.h"
+#include "primitives/Vertex.h"
+
+/* The number of candidates per squared radius of area: (more candidates give a more maximal sampling) */
+#define POISSON_DISK_CANDIDATES 6.f
+
+/* The smallest relative density, which gives a radius 10 times larger than at density 1: */
+#define POISSON_DISK_MIN_DENSITY 0.01f
+
+/**
+ * \brief Blue noise samples on the surface of triangles, which are at least a radius away from each other. (Poisson disk)
+ * Uniform candidates of a 'SurfaceSampler' are kept in proportion to the density and then thrown as darts in
+ * their random order, where each is accepted if no accepted sample is too close. The darts are grouped by cells
+ * of a grid which are at least as large as the largest radius. Cells whose coordinates have the same parities
+ * (8 phases) are never neighbours, so the cells of a phase are processed in parallel and the result does not
+ * depend on the number of threads.
+ */
+class PoissonDiskSampler
+{
+public:
+	/**
+	 * \brief The constructor. Generates the samples.
+	 * The radius at a point is radius / sqrt(density), and two samples are at least the smaller of their radii apart.
+	 * \param triangles The triangles. (they have to outlive the sampler)
+	 * \param radius The radius at density 1.
+	 * \param densities The relative densities of the corners, 3 per triangle. (uniform if empty, at most 1, no samples at 0)
+	 * \param seed The seed of the random candidates.
+	 */
+	PoissonDiskSampler(const std::vector<Triangle>& triangles, float radius,
+		const std::vector<float>& densities = std::vector<float>(), uint64_t seed = 0);
+
+	/**
+	 * \brief Returns the luminance of the vertex colors as densities.
+	 * \param triangles The triangles.
+	 * \return The densities. (3 per triangle)
+	 */
+	static std::vector<float> densities_from_colors(const std::vector<Triangle>& triangles);
+
+	/**
+	 * \brief Returns the samples.
+	 * \return The samples.
+	 */
+	const std::vector<SurfaceSample>& get_samples() const;
+
+	/**
+	 * \brief Returns the positions of the samples.
+	 * \return The positions.
+	 */
+	std::vector<Vec3f> get_positions() const;
+
+	/**
+	 * \brief Returns the samples with all interpolated attributes.
+	 * \return The vertices.
+	 */
+	std::vector<Vertex> get_vertices() const;
+
+private:
+	/**
+	 * \brief The triangles.
+	 */
+	const std::vector<Triangle>& triangles;
+
+	/**
+	 * \brief The samples in the order of their candidates.
+	 */
+	std::vector<SurfaceSample> samples;
+};
@@ -0,0 +1,221 @@
+#include "RayQuery.h"
+
+#include <algorithm>
+
+#include "utilities/Parallel.h"
+
+/* The number of rays which are traversed together by the batched query: */
+#define RAY_PACKET_SIZE 8
+
+namespace
+{
+	/**
+	 * \brief Intersects a ray with the bounding box of a node. (slab test)
+	 * \return Whether the box is hit within the maximum distance.
+	 */
+	inline bool intersect_box(const BVHNode& node, Vec3f origin, Vec3f inverse_direction, float max_distance)
+	{
+		float t_min = 0.f, t_max = max_distance;
+		for (int i = 0; i < 3; i++)
+		{
+			const float t0 = (node.bounds_min[i] - origin[i]) * inverse_direction[i];
+			const float t1 = (node.bounds_max[i] - origin[i]) * inverse_direction[i];
+			t_min = std::max(t_min, std::min(t0, t1));
+			t_max = std::min(t_max, std::max(t0, t1));
+		}
+		return t_min <= t_max;
+	}
+}
+
+RayQuery::RayQuery(const BVH& bvh)
+	: bvh(bvh)
+{
+}
+
+bool RayQuery::intersect(Ray ray, RayHit& hit, float max_distance) const
+{
+	return traverse(ray, hit, max_distance, false);
+}
+
+bool RayQuery::occluded(Ray ray, float max_distance) const
+{
+	RayHit hit;
+	return traverse(ray, hit, max_distance, true);
+}
+
+void RayQuery::intersect(const RayPacket<4>& packet, RayHit hits[4]) const
+{
+	traverse<4>(packet, hits);
+}
+
+void RayQuery::intersect(const RayPacket<8>& packet, RayHit hits[8]) const
+{
+	traverse<8>(packet, hits);
+}
+
+void RayQuery::intersect(const Ray* rays, size_t count, RayHit* hits, float max_distance) const
+{
+	const size_t packets = (count + RAY_PACKET_SIZE - 1) / RAY_PACKET_SIZE;
+	Utilities::parallel_for(packets, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t p = begin; p < end; p++)
+		{
+			const size_t first = p * RAY_PACKET_SIZE;
+			const int lanes = static_cast<int>(std::min<size_t>(RAY_PACKET_SIZE, count - first));
+
+			RayPacket<RAY_PACKET_SIZE> packet;
+			for (int lane = 0; lane < lanes; lane++)
+				packet.set(lane, rays[first + lane], max_distance);
+
+			RayHit packet_hits[RAY_PACKET_SIZE];
+			traverse<RAY_PACKET_SIZE>(packet, packet_hits);
+			std::copy(packet_hits, packet_hits + lanes, hits + first);
+		}
+	}, 32);
+}
+
+bool RayQuery::traverse(Ray ray, RayHit& hit, float max_distance, bool any) const
+{
+	hit.triangle = NO_TRIANGLE;
+	hit.distance = std::numeric_limits<float>::infinity();
+	if (bvh.empty()) return false;
+
+	const Vec3f origin(ray.origin), direction(ray.direction);
+	const Vec3f inverse_direction(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+	const std::vector<BVHNode>& nodes = bvh.get_nodes();
+
+	float best = max_distance;
+	uint32_t best_primitive = NO_TRIANGLE;
+
+	uint32_t stack[BVH_MAX_DEPTH + 1];
+	int size = 0;
+	if (intersect_box(nodes[0], origin, inverse_direction, best))
+		stack[size++] = 0;
+	while (size > 0)
+	{
+		const BVHNode& node = nodes[stack[--size]];
+		if (!intersect_box(node, origin, inverse_direction, best)) continue;
+
+		if (node.is_leaf())
+		{
+			for (uint32_t i = node.index; i < node.index + node.count; i++)
+			{
+				const Vec3f* v = bvh.get_vertices(i);
+				float t;
+				Barycentric barycentric;
+				if (Triangle::intersect(origin, direction, v[0], v[1], v[2], t, barycentric) && t <= best)
+				{
+					best = t;
+					best_primitive = i;
+					hit.barycentric = barycentric;
+					if (any) break;
+				}
+			}
+			if (any && best_primitive != NO_TRIANGLE) break;
+			continue;
+		}
+
+		// visits the child first which lies first along the ray
+		const bool left_first = direction[node.axis] >= 0.f;
+		stack[size++] = left_first ? node.index + 1 : node.index;
+		stack[size++] = left_first ? node.index : node.index + 1;
+	}
+
+	if (best_primitive == NO_TRIANGLE) return false;
+	hit.triangle = bvh.get_triangle_id(best_primitive);
+	hit.distance = best;
+	return true;
+}
+
+template <int N>
+void RayQuery::traverse(const RayPacket<N>& packet, RayHit* hits) const
+{
+	float best[N], inverse_direction[3][N];
+	uint32_t best_primitive[N];
+	float best_u[N], best_v[N];
+	float average_direction[3] = { 0, 0, 0 };
+	for (int lane = 0; lane < N; lane++)
+	{
+		best[lane] = packet.max_distance[lane];
+		best_primitive[lane] = NO_TRIANGLE;
+		best_u[lane] = best_v[lane] = 0.f;
+		for (int i = 0; i < 3; i++)
+		{
+			inverse_direction[i][lane] = 1.f / packet.direction[i][lane];
+			average_direction[i] += packet.direction[i][lane];
+		}
+	}
+
+	const std::vector<BVHNode>& nodes = bvh.get_nodes();
+	uint32_t stack[BVH_MAX_DEPTH + 1];
+	int size = 0;
+	if (!bvh.empty())
+		stack[size++] = 0;
+	while (size > 0)
+	{
+		const BVHNode& node = nodes[stack[--size]];
+
+		// the node is visited if at least one ray hits its box
+		bool active = false;
+		for (int lane = 0; lane < N; lane++)
+		{
+			float t_min = 0.f, t_max = best[lane];
+			for (int i = 0; i < 3; i++)
+			{
+				const float t0 = (node.bounds_min[i] - packet.origin[i][lane]) * inverse_direction[i][lane];
+				const float t1 = (node.bounds_max[i] - packet.origin[i][lane]) * inverse_direction[i][lane];
+				t_min = std::max(t_min, std::min(t0, t1));
+				t_max = std::min(t_max, std::max(t0, t1));
+			}
+			active |= t_min <= t_max;
+		}
+		if (!active) continue;
+
+		if (node.is_leaf())
+		{
+			for (uint32_t p = node.index; p < node.index + node.count; p++)
+			{
+				// the edges are shared by all rays
+				const Vec3f* v = bvh.get_vertices(p);
+				const Vec3f ab = v[1] - v[0], ac = v[2] - v[0];
+				for (int lane = 0; lane < N; lane++)
+				{
+					// Moller-Trumbore without early exits
+					const Vec3f d(packet.direction[0][lane], packet.direction[1][lane], packet.direction[2][lane]);
+					const Vec3f s = Vec3f(packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane]) - v[0];
+					const Vec3f pv = d.cross(ac);
+					const float det = ab.dot(pv);
+					const float inverse_det = 1.f / det;
+					const Vec3f q = s.cross(ab);
+					const float u = s.dot(pv) * inverse_det;
+					const float w = d.dot(q) * inverse_det;
+					const float t = ac.dot(q) * inverse_det;
+					const bool hit = det != 0.f && u >= 0.f && w >= 0.f && u + w <= 1.f && t >= 0.f && t <= best[lane];
+					best[lane] = hit ? t : best[lane];
+					best_u[lane] = hit ? u : best_u[lane];
+					best_v[lane] = hit ? w : best_v[lane];
+					best_primitive[lane] = hit ? p : best_primitive[lane];
+				}
+			}
+			continue;
+		}
+
+		// visits the child first which lies first along the average direction
+		const bool left_first = average_direction[node.axis] >= 0.f;
+		stack[size++] = left_first ? node.index + 1 : node.index;
+		stack[size++] = left_first ? node.index : node.index + 1;
+	}
+
+	for (int lane = 0; lane < N; lane++)
+	{
+		if (best_primitive[lane] == NO_TRIANGLE)
+		{
+			hits[lane].triangle = NO_TRIANGLE;
+			hits[lane].distance = std::numeric_limits<float>::infinity();
+			continue;
+		}
+		hits[lane].triangle = bvh.get_triangle_id(best_primitive[lane]);
+		hits[lane].barycentric = Barycentric(1 - best_u[lane] - best_v[lane], best_u[lane], best_v[lane]);
+		hits[lane].distance = best[lane];
+	}
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "geometry/BVH.h"
+#include "primitives/Barycentric.h"
+#include "primitives/Ray.h"
+
+/**
+ * \brief The first hit of a ray.
+ */
+struct RayHit
+{
+	/**
+	 * \brief The id of the hit triangle. ('RayQuery::NO_TRIANGLE' if nothing was hit)
+	 */
+	uint32_t triangle;
+
+	/**
+	 * \brief The barycentric coordinates of the hit in the triangle.
+	 */
+	Barycentric barycentric;
+
+	/**
+	 * \brief The distance along the ray. (in units of the direction length)
+	 */
+	float distance;
+};
+
+/**
+ * \brief N rays in structure of arrays layout, so each step of the traversal can be vectorized.
+ * \tparam N The number of rays.
+ */
+template <int N>
+struct RayPacket
+{
+	/**
+	 * \brief The origins. (per axis)
+	 */
+	float origin[3][N];
+
+	/**
+	 * \brief The directions. (per axis)
+	 */
+	float direction[3][N];
+
+	/**
+	 * \brief The maximum distances. (negative for unused lanes)
+	 */
+	float max_distance[N];
+
+	/**
+	 * \brief The constructor. (All lanes are unused)
+	 */
+	RayPacket()
+	{
+		for (int lane = 0; lane < N; lane++)
+			set(lane, Ray(), -1.f);
+	}
+
+	/**
+	 * \brief Sets a ray.
+	 * \param lane The lane.
+	 * \param ray The ray.
+	 * \param distance The maximum distance.
+	 */
+	void set(int lane, Ray ray, float distance = std::numeric_limits<float>::infinity())
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			origin[i][lane] = ray.origin[i];
+			direction[i][lane] = ray.direction[i];
+		}
+		max_distance[lane] = distance;
+	}
+};
+
+/**
+ * \brief Intersects rays with the triangles of a bounding volume hierarchy.
+ */
+class RayQuery
+{
+public:
+	/**
+	 * \brief The triangle id if nothing was hit.
+	 */
+	static const uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+	/**
+	 * \brief The constructor.
+	 * \param bvh The bounding volume hierarchy. (Has to outlive the query)
+	 */
+	explicit RayQuery(const BVH& bvh);
+
+	/**
+	 * \brief Finds the first hit of a ray. (e.g. for picking)
+	 * \param ray The ray.
+	 * \param hit The first hit.
+	 * \param max_distance The maximum distance.
+	 * \return Whether a triangle was hit.
+	 */
+	bool intersect(Ray ray, RayHit& hit, float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * \brief Checks whether a ray hits any triangle. (Stops at the first hit found)
+	 * \param ray The ray.
+	 * \param max_distance The maximum distance.
+	 * \return Whether a triangle was hit.
+	 */
+	bool occluded(Ray ray, float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	/**
+	 * \brief Finds the first hits of a packet of 4 rays.
+	 * \param packet The rays.
+	 * \param hits The first hits.
+	 */
+	void intersect(const RayPacket<4>& packet, RayHit hits[4]) const;
+
+	/**
+	 * \brief Finds the first hits of a packet of 8 rays.
+	 * \param packet The rays.
+	 * \param hits The first hits.
+	 */
+	void intersect(const RayPacket<8>& packet, RayHit hits[8]) const;
+
+	/**
+	 * \brief Finds the first hits of many rays on all threads. (Traversed in packets of 8)
+	 * Coherent rays should be next to each other.
+	 * \param rays The rays.
+	 * \param count The number of rays.
+	 * \param hits The first hits.
+	 * \param max_distance The maximum distance.
+	 */
+	void intersect(const Ray* rays, size_t count, RayHit* hits, float max_distance = std::numeric_limits<float>::infinity()) const;
+
+private:
+	/**
+	 * \brief Traverses the hierarchy with a single ray.
+	 * \param ray The ray.
+	 * \param hit The first hit.
+	 * \param max_distance The maximum distance.
+	 * \param any Whether to stop at the first hit found.
+	 * \return Whether a triangle was hit.
+	 */
+	bool traverse(Ray ray, RayHit& hit, float max_distance, bool any) const;
+
+	/**
+	 * \brief Traverses the hierarchy with a packet of rays.
+	 * \tparam N The number of rays.
+	 * \param packet The rays.
+	 * \param hits The first hits.
+	 */
+	template <int N>
+	void traverse(const RayPacket<N>& packet, RayHit* hits) const;
+
+	/**
+	 * \brief The bounding volume hierarchy.
+	 */
+	const BVH& bvh;
+};
@@ -0,0 +1,156 @@
+#include "SignedDistanceField.h"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include "geometry/BVH.h"
+#include "geometry/ClosestPointQuery.h"
+#include "geometry/WindingNumberQuery.h"
+#include "utilities/Parallel.h"
+
+/* The spheres around neighbouring samples have to cover this multiple of their distance, so rounding cannot hide a crossing surface: */
+#define SDF_SIGN_MARGIN 1.01f
+
+SignedDistanceField::SignedDistanceField(const std::vector<Triangle>& triangles, uint32_t resolution, float band)
+	: dimensions{ 0, 0, 0 }, voxel_size(0.f)
+{
+	const uint32_t padding = static_cast<uint32_t>(std::ceil(band));
+	if (!(band > 0.f) || resolution < 2 * padding + 2)
+		throw std::invalid_argument("'SignedDistanceField' should only be called with a positive band and a resolution above twice the band.");
+	if (triangles.empty()) return;
+
+	// cubic voxels over the bounds, padded by the band
+	Vec3f bounds_min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+	Vec3f bounds_max = -bounds_min;
+	for (const Triangle& triangle : triangles)
+	{
+		for (int v = 0; v < 3; v++)
+		{
+			bounds_min = Vec3f::min(bounds_min, Vec3f(triangle.vertices[v].position));
+			bounds_max = Vec3f::max(bounds_max, Vec3f(triangle.vertices[v].position));
+		}
+	}
+	const Vec3f extent = bounds_max - bounds_min;
+	const float longest = std::max(extent.x, std::max(extent.y, extent.z));
+	voxel_size = longest > 0.f ? longest / static_cast<float>(resolution - 1 - 2 * padding) : 1.f;
+	const Vec3f start = bounds_min - Vec3f(1.f, 1.f, 1.f) * (static_cast<float>(padding) * voxel_size);
+	origin = start.toPoint();
+	for (int axis = 0; axis < 3; axis++)
+	{
+		const uint32_t samples = static_cast<uint32_t>(std::ceil(extent[axis] / voxel_size)) + 1 + 2 * padding;
+		dimensions[axis] = std::min(samples, resolution);
+	}
+	values.resize(static_cast<size_t>(dimensions[0]) * dimensions[1] * dimensions[2]);
+
+	const BVH bvh(triangles);
+	const ClosestPointQuery closest(bvh);
+	const WindingNumberQuery winding(bvh);
+	const float band_distance = band * voxel_size;
+
+	uint32_t bricks[3];
+	for (int axis = 0; axis < 3; axis++)
+		bricks[axis] = (dimensions[axis] + SDF_BRICK_SIZE - 1) / SDF_BRICK_SIZE;
+	const size_t brick_count = static_cast<size_t>(bricks[0]) * bricks[1] * bricks[2];
+
+	Utilities::parallel_for(brick_count, [&](size_t first, size_t last, unsigned int)
+	{
+		for (size_t brick = first; brick < last; brick++)
+		{
+			const uint32_t index[3] = {
+				static_cast<uint32_t>(brick % bricks[0]),
+				static_cast<uint32_t>(brick / bricks[0] % bricks[1]),
+				static_cast<uint32_t>(brick / bricks[0] / bricks[1]) };
+			uint32_t begin[3], end[3];
+			Vec3f center;
+			float half_diagonal = 0.f;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				begin[axis] = index[axis] * SDF_BRICK_SIZE;
+				end[axis] = std::min(begin[axis] + SDF_BRICK_SIZE, dimensions[axis]);
+				const float span = static_cast<float>(end[axis] - begin[axis] - 1) * voxel_size;
+				center[axis] = start[axis] + static_cast<float>(begin[axis]) * voxel_size + 0.5f * span;
+				half_diagonal += 0.25f * span * span;
+			}
+			half_diagonal = std::sqrt(half_diagonal);
+
+			// a brick outside of the band is on one side of the surface
+			ClosestPointResult result;
+			if (!closest.find(center.toPoint(), result, band_distance + half_diagonal))
+			{
+				const float distance = winding.is_inside(center.toPoint()) ? -band_distance : band_distance;
+				for (uint32_t z = begin[2]; z < end[2]; z++)
+				{
+					for (uint32_t y = begin[1]; y < end[1]; y++)
+					{
+						const size_t row = (static_cast<size_t>(z) * dimensions[1] + y) * dimensions[0];
+						std::fill(values.begin() + row + begin[0], values.begin() + row + end[0], distance);
+					}
+				}
+				continue;
+			}
+
+			// the sign is copied from the previous sample if the empty spheres around both cover the step between them
+			for (uint32_t z = begin[2]; z < end[2]; z++)
+			{
+				for (uint32_t y = begin[1]; y < end[1]; y++)
+				{
+					const size_t row = (static_cast<size_t>(z) * dimensions[1] + y) * dimensions[0];
+					for (uint32_t x = begin[0]; x < end[0]; x++)
+					{
+						const Vec4f p = (start + Vec3f(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) * voxel_size).toPoint();
+						const float distance = closest.find(p, result, band_distance) ? result.distance : band_distance;
+
+						size_t previous = values.size();
+						if (x > begin[0]) previous = row + x - 1;
+						else if (y > begin[1]) previous = row - dimensions[0] + x;
+						else if (z > begin[2]) previous = row - static_cast<size_t>(dimensions[0]) * dimensions[1] + x;
+
+						const bool inside = previous != values.size() && std::abs(values[previous]) + distance > SDF_SIGN_MARGIN * voxel_size
+							? std::signbit(values[previous]) : winding.is_inside(p);
+						values[row + x] = inside ? -distance : distance;
+					}
+				}
+			}
+		}
+	}, 1);
+}
+
+uint32_t SignedDistanceField::dimension(int axis) const
+{
+	return dimensions[axis];
+}
+
+Vec4f SignedDistanceField::get_origin() const
+{
+	return origin;
+}
+
+float SignedDistanceField::get_voxel_size() const
+{
+	return voxel_size;
+}
+
+float SignedDistanceField::value(uint32_t x, uint32_t y, uint32_t z) const
+{
+	return values[(static_cast<size_t>(z) * dimensions[1] + y) * dimensions[0] + x];
+}
+
+const std::vector<float>& SignedDistanceField::get_values() const
+{
+	return values;
+}
+
+bool SignedDistanceField::save(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "Signed distance field " << path << " could not be written." << std::endl;
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(float)));
+	return static_cast<bool>(file);
+}
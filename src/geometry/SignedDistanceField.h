@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "primitives/Triangle.h"
+
+/* The number of samples per axis of the bricks which are distributed over the threads: */
+#define SDF_BRICK_SIZE 8
+
+/**
+ * \brief A signed distance field of a mesh, sampled on a regular 3D grid. (negative inside)
+ * The distances come from closest point queries and the signs from generalized winding numbers, so meshes with
+ * holes are supported. Only samples within a narrow band around the surface get exact distances, all others are
+ * clamped to the band. Bricks which are entirely outside of the band only need a single winding number, and inside
+ * the band the sign is only evaluated where the surface may pass between neighbouring samples.
+ */
+class SignedDistanceField
+{
+public:
+	/**
+	 * \brief The constructor. Bakes the field on all threads.
+	 * The grid covers the bounds of the triangles and the band around them with cubic voxels.
+	 * \param triangles The triangles. (e.g. of 'Mesh::get_triangles')
+	 * \param resolution The number of samples along the longest axis.
+	 * \param band The half width of the band with exact distances in voxels.
+	 */
+	SignedDistanceField(const std::vector<Triangle>& triangles, uint32_t resolution, float band = 4.f);
+
+	/**
+	 * \brief Returns the number of samples along an axis.
+	 * \param axis The axis. (0-2)
+	 * \return The number of samples.
+	 */
+	uint32_t dimension(int axis) const;
+
+	/**
+	 * \brief Returns the position of the first sample.
+	 * \return The position.
+	 */
+	Vec4f get_origin() const;
+
+	/**
+	 * \brief Returns the distance between neighbouring samples.
+	 * \return The voxel size.
+	 */
+	float get_voxel_size() const;
+
+	/**
+	 * \brief Returns a sample.
+	 * \param x The index along the x axis.
+	 * \param y The index along the y axis.
+	 * \param z The index along the z axis.
+	 * \return The signed distance.
+	 */
+	float value(uint32_t x, uint32_t y, uint32_t z) const;
+
+	/**
+	 * \brief Returns all samples. (x changes fastest, then y, then z)
+	 * \return The signed distances.
+	 */
+	const std::vector<float>& get_values() const;
+
+	/**
+	 * \brief Writes the samples as raw 32 bit floats in the order of 'get_values', which can be memory mapped.
+	 * \param path The file path.
+	 * \return Whether the file was written.
+	 */
+	bool save(const std::string& path) const;
+
+private:
+	/**
+	 * \brief The number of samples per axis.
+	 */
+	uint32_t dimensions[3];
+
+	/**
+	 * \brief The position of the first sample.
+	 */
+	Vec4f origin;
+
+	/**
+	 * \brief The distance between neighbouring samples.
+	 */
+	float voxel_size;
+
+	/**
+	 * \brief The signed distances.
+	 */
+	std::vector<float> values;
+};
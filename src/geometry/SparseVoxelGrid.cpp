@@ -0,0 +1,244 @@
+#include "SparseVoxelGrid.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <stdexcept>
+
+#include "math/Vec3f.h"
+#include "utilities/Parallel.h"
+
+/* The largest supported voxel coordinate, so brick coordinates fit into 21 bits: */
+#define VOXEL_MAX_COORDINATE (1 << 23)
+
+/* The number of triangles per bin which is voxelized by one thread at a time: */
+#define VOXEL_TRIANGLE_BIN 1024
+
+namespace
+{
+	/**
+	 * \brief Divides a voxel coordinate by the brick size, rounding down.
+	 */
+	inline int32_t brick_coordinate(int32_t v)
+	{
+		return v >= 0 ? v / VOXEL_BRICK_SIZE : -((-v + VOXEL_BRICK_SIZE - 1) / VOXEL_BRICK_SIZE);
+	}
+
+	/**
+	 * \brief The bricks filled by one thread.
+	 */
+	struct LocalBricks
+	{
+		std::vector<VoxelBrick> bricks;
+		std::unordered_map<uint64_t, uint32_t> indices;
+	};
+
+	/**
+	 * \brief The setup of a triangle for the overlap tests against voxels. (Schwarz and Seidel 2010)
+	 */
+	struct TriangleSetup
+	{
+		/**
+		 * \brief The normal and the plane offsets of the nearest and farthest voxel corner.
+		 */
+		Vec3f normal;
+		float d1, d2;
+
+		/**
+		 * \brief The edge normals and offsets in the yz, zx and xy projections. (3 edges each)
+		 */
+		float edge_normals[3][3][2];
+		float edge_offsets[3][3];
+
+		TriangleSetup(const Vec3f* v, float size)
+		{
+			const Vec3f edges[3] = { v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+			normal = edges[0].cross(v[2] - v[0]);
+			const Vec3f critical(normal.x > 0.f ? size : 0.f, normal.y > 0.f ? size : 0.f, normal.z > 0.f ? size : 0.f);
+			d1 = normal.dot(critical - v[0]);
+			d2 = normal.dot(Vec3f(size, size, size) - critical - v[0]);
+
+			// the projection along each axis keeps the two following axes
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const int a = (axis + 1) % 3, b = (axis + 2) % 3;
+				const float sign = normal[axis] >= 0.f ? 1.f : -1.f;
+				for (int i = 0; i < 3; i++)
+				{
+					const float na = -edges[i][b] * sign, nb = edges[i][a] * sign;
+					edge_normals[axis][i][0] = na;
+					edge_normals[axis][i][1] = nb;
+					edge_offsets[axis][i] = -(na * v[i][a] + nb * v[i][b]) + std::max(0.f, size * na) + std::max(0.f, size * nb);
+				}
+			}
+		}
+
+		/**
+		 * \brief Whether the projections of the triangle and the voxel along an axis overlap.
+		 */
+		bool overlaps(int axis, float pa, float pb) const
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				if (edge_normals[axis][i][0] * pa + edge_normals[axis][i][1] * pb + edge_offsets[axis][i] < 0.f) return false;
+			}
+			return true;
+		}
+	};
+}
+
+SparseVoxelGrid::SparseVoxelGrid(const std::vector<Triangle>& triangles, float voxel_size)
+	: voxel_size(voxel_size)
+{
+	if (!(voxel_size > 0.f))
+		throw std::invalid_argument("'SparseVoxelGrid' should only be called with a positive voxel size.");
+	const float inverse = 1.f / voxel_size;
+	for (const Triangle& triangle : triangles)
+	{
+		for (int v = 0; v < 3; v++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (!(std::abs(triangle.vertices[v].position[axis] * inverse) < VOXEL_MAX_COORDINATE))
+					throw std::invalid_argument("'SparseVoxelGrid' should only be called with less than 2^23 voxels from the origin per axis.");
+			}
+		}
+	}
+
+	std::vector<LocalBricks> local(Utilities::thread_count());
+	Utilities::parallel_for(triangles.size(), [&](size_t begin, size_t end, unsigned int thread)
+	{
+		LocalBricks& target = local[thread];
+		uint64_t cached_key = ~0ull;
+		uint32_t cached_index = 0;
+		const auto set = [&](int32_t x, int32_t y, int32_t z)
+		{
+			const int32_t bx = brick_coordinate(x), by = brick_coordinate(y), bz = brick_coordinate(z);
+			const uint64_t key = brick_key(bx, by, bz);
+			if (key != cached_key)
+			{
+				const auto inserted = target.indices.emplace(key, static_cast<uint32_t>(target.bricks.size()));
+				if (inserted.second)
+				{
+					VoxelBrick brick = { bx, by, bz, {} };
+					target.bricks.push_back(brick);
+				}
+				cached_key = key;
+				cached_index = inserted.first->second;
+			}
+			target.bricks[cached_index].bits[(y - VOXEL_BRICK_SIZE * by) + VOXEL_BRICK_SIZE * (z - VOXEL_BRICK_SIZE * bz)]
+				|= static_cast<uint8_t>(1u << (x - VOXEL_BRICK_SIZE * bx));
+		};
+
+		for (size_t t = begin; t < end; t++)
+		{
+			Vec3f v[3];
+			for (int i = 0; i < 3; i++)
+				v[i] = Vec3f(triangles[t].vertices[i].position);
+			const Vec3f low = Vec3f::min(v[0], Vec3f::min(v[1], v[2])), high = Vec3f::max(v[0], Vec3f::max(v[1], v[2]));
+			int32_t first[3], last[3];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				first[axis] = static_cast<int32_t>(std::floor(low[axis] * inverse));
+				last[axis] = static_cast<int32_t>(std::floor(high[axis] * inverse));
+			}
+
+			// a triangle inside a single voxel needs no test
+			if (first[0] == last[0] && first[1] == last[1] && first[2] == last[2])
+			{
+				set(first[0], first[1], first[2]);
+				continue;
+			}
+
+			const TriangleSetup setup(v, voxel_size);
+			for (int32_t z = first[2]; z <= last[2]; z++)
+			{
+				const float pz = static_cast<float>(z) * voxel_size;
+				for (int32_t y = first[1]; y <= last[1]; y++)
+				{
+					// the projection along x is the same for the whole row
+					const float py = static_cast<float>(y) * voxel_size;
+					if (!setup.overlaps(0, py, pz)) continue;
+					const float row = setup.normal.y * py + setup.normal.z * pz;
+					for (int32_t x = first[0]; x <= last[0]; x++)
+					{
+						const float px = static_cast<float>(x) * voxel_size;
+						const float plane = setup.normal.x * px + row;
+						if ((plane + setup.d1) * (plane + setup.d2) > 0.f) continue;
+						if (!setup.overlaps(1, pz, px) || !setup.overlaps(2, px, py)) continue;
+						set(x, y, z);
+					}
+				}
+			}
+		}
+	}, VOXEL_TRIANGLE_BIN);
+
+	// merges the bricks of all threads, sorted so the result does not depend on the scheduling
+	for (LocalBricks& source : local)
+	{
+		for (const VoxelBrick& brick : source.bricks)
+		{
+			const auto inserted = brick_indices.emplace(brick_key(brick.x, brick.y, brick.z), static_cast<uint32_t>(bricks.size()));
+			if (inserted.second)
+			{
+				bricks.push_back(brick);
+				continue;
+			}
+			VoxelBrick& target = bricks[inserted.first->second];
+			for (int i = 0; i < VOXEL_BRICK_SIZE * VOXEL_BRICK_SIZE; i++)
+				target.bits[i] |= brick.bits[i];
+		}
+		source = LocalBricks();
+	}
+	std::sort(bricks.begin(), bricks.end(), [](const VoxelBrick& a, const VoxelBrick& b)
+	{
+		return a.z != b.z ? a.z < b.z : (a.y != b.y ? a.y < b.y : a.x < b.x);
+	});
+	for (uint32_t i = 0; i < bricks.size(); i++)
+		brick_indices[brick_key(bricks[i].x, bricks[i].y, bricks[i].z)] = i;
+}
+
+float SparseVoxelGrid::get_voxel_size() const
+{
+	return voxel_size;
+}
+
+const std::vector<VoxelBrick>& SparseVoxelGrid::get_bricks() const
+{
+	return bricks;
+}
+
+size_t SparseVoxelGrid::voxel_count() const
+{
+	size_t count = 0;
+	for (const VoxelBrick& brick : bricks)
+	{
+		for (uint8_t row : brick.bits)
+			count += std::bitset<8>(row).count();
+	}
+	return count;
+}
+
+bool SparseVoxelGrid::is_set(int32_t x, int32_t y, int32_t z) const
+{
+	const int32_t bx = brick_coordinate(x), by = brick_coordinate(y), bz = brick_coordinate(z);
+	const auto found = brick_indices.find(brick_key(bx, by, bz));
+	return found != brick_indices.end() && bricks[found->second].is_set(x - VOXEL_BRICK_SIZE * bx, y - VOXEL_BRICK_SIZE * by, z - VOXEL_BRICK_SIZE * bz);
+}
+
+bool SparseVoxelGrid::is_occupied(Vec4f point) const
+{
+	const float inverse = 1.f / voxel_size;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (!(std::abs(point[axis] * inverse) < VOXEL_MAX_COORDINATE)) return false;
+	}
+	return is_set(static_cast<int32_t>(std::floor(point.x * inverse)), static_cast<int32_t>(std::floor(point.y * inverse)),
+		static_cast<int32_t>(std::floor(point.z * inverse)));
+}
+
+uint64_t SparseVoxelGrid::brick_key(int32_t x, int32_t y, int32_t z)
+{
+	const uint64_t offset = VOXEL_MAX_COORDINATE / VOXEL_BRICK_SIZE;
+	return (static_cast<uint64_t>(x + offset) << 42) | (static_cast<uint64_t>(y + offset) << 21) | static_cast<uint64_t>(z + offset);
+}
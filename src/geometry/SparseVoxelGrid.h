@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "primitives/Triangle.h"
+
+/* The number of voxels per axis of a brick: */
+#define VOXEL_BRICK_SIZE 8
+
+/**
+ * \brief A brick of 8^3 voxels with one occupancy bit each.
+ */
+struct VoxelBrick
+{
+	/**
+	 * \brief The brick coordinates. (voxel coordinates divided by 'VOXEL_BRICK_SIZE')
+	 */
+	int32_t x, y, z;
+
+	/**
+	 * \brief The occupancy bits. (bit x of word y + 8 * z)
+	 */
+	uint8_t bits[VOXEL_BRICK_SIZE * VOXEL_BRICK_SIZE];
+
+	/**
+	 * \brief Whether a voxel of the brick is set.
+	 * \param x The x coordinate in the brick. (0-7)
+	 * \param y The y coordinate in the brick. (0-7)
+	 * \param z The z coordinate in the brick. (0-7)
+	 * \return Is the voxel set.
+	 */
+	bool is_set(int x, int y, int z) const
+	{
+		return (bits[y + VOXEL_BRICK_SIZE * z] >> x & 1) != 0;
+	}
+};
+
+/**
+ * \brief A conservative voxelization of triangles: every voxel which a triangle touches is set.
+ * Only bricks with set voxels are stored, so the memory scales with the surface area. The overlap test is the
+ * triangle-box separating axis test in the form of Schwarz and Seidel, where most of the work is done once per
+ * triangle. The triangles are split into bins over all threads, which fill their own bricks that are merged at the end.
+ */
+class SparseVoxelGrid
+{
+public:
+	/**
+	 * \brief The constructor. Voxel (0, 0, 0) starts at the origin.
+	 * \param triangles The triangles. (e.g. of 'Mesh::get_triangles')
+	 * \param voxel_size The edge length of the voxels.
+	 */
+	SparseVoxelGrid(const std::vector<Triangle>& triangles, float voxel_size);
+
+	/**
+	 * \brief Returns the edge length of the voxels.
+	 * \return The voxel size.
+	 */
+	float get_voxel_size() const;
+
+	/**
+	 * \brief Returns all bricks with set voxels.
+	 * \return The bricks.
+	 */
+	const std::vector<VoxelBrick>& get_bricks() const;
+
+	/**
+	 * \brief Returns the number of set voxels.
+	 * \return The number of voxels.
+	 */
+	size_t voxel_count() const;
+
+	/**
+	 * \brief Whether a voxel is set.
+	 * \param x The x coordinate.
+	 * \param y The y coordinate.
+	 * \param z The z coordinate.
+	 * \return Is the voxel set.
+	 */
+	bool is_set(int32_t x, int32_t y, int32_t z) const;
+
+	/**
+	 * \brief Whether the voxel which contains a point is set.
+	 * \param point The point.
+	 * \return Is the point in a set voxel.
+	 */
+	bool is_occupied(Vec4f point) const;
+
+private:
+	/**
+	 * \brief Returns the key of a brick.
+	 * \param x The x coordinate of the brick.
+	 * \param y The y coordinate of the brick.
+	 * \param z The z coordinate of the brick.
+	 * \return The key.
+	 */
+	static uint64_t brick_key(int32_t x, int32_t y, int32_t z);
+
+	/**
+	 * \brief The edge length of the voxels.
+	 */
+	float voxel_size;
+
+	/**
+	 * \brief The bricks.
+	 */
+	std::vector<VoxelBrick> bricks;
+
+	/**
+	 * \brief The index of each brick by its key.
+	 */
+	std::unordered_map<uint64_t, uint32_t> brick_indices;
+};
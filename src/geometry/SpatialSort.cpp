@@ -0,0 +1,126 @@
+#include "SpatialSort.h"
+
+#include <limits>
+#include <stdexcept>
+
+#include "math/Morton.h"
+#include "utilities/Parallel.h"
+#include "utilities/RadixSort.h"
+
+std::vector<uint32_t> SpatialSort::morton_order(const std::vector<Vec3f>& points)
+{
+	if (points.size() >= 0xFFFFFFFFull)
+		throw std::invalid_argument("'SpatialSort::morton_order' should only be called with less than 2^32 points.");
+
+	Vec3f min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+	Vec3f max = -min;
+	for (const Vec3f& point : points)
+	{
+		min = Vec3f::min(min, point);
+		max = Vec3f::max(max, point);
+	}
+	const float cells = static_cast<float>((1 << SPATIAL_SORT_MORTON_BITS) - 1);
+	float scale[3];
+	for (int axis = 0; axis < 3; axis++)
+		scale[axis] = max[axis] > min[axis] ? cells / (max[axis] - min[axis]) : 0.f;
+
+	// the Morton code in the upper and the point id in the lower 32 bits
+	std::vector<uint64_t> keys(points.size());
+	Utilities::parallel_for(points.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const uint64_t code = Morton::encode(
+				Morton::quantize(points[i].x, min.x, scale[0], SPATIAL_SORT_MORTON_BITS),
+				Morton::quantize(points[i].y, min.y, scale[1], SPATIAL_SORT_MORTON_BITS),
+				Morton::quantize(points[i].z, min.z, scale[2], SPATIAL_SORT_MORTON_BITS));
+			keys[i] = code << 32 | i;
+		}
+	}, 16384);
+	Utilities::radix_sort(keys, 32, 32 + 3 * SPATIAL_SORT_MORTON_BITS);
+
+	std::vector<uint32_t> order(points.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = static_cast<uint32_t>(keys[i] & 0xFFFFFFFFull);
+	return order;
+}
+
+std::vector<uint32_t> SpatialSort::sort_triangles(std::vector<Triangle>& triangles, std::vector<uint32_t>& indices)
+{
+	if (!indices.empty() && indices.size() != 3 * triangles.size())
+		throw std::invalid_argument("'SpatialSort::sort_triangles' should only be called with 3 indices per triangle.");
+
+	std::vector<Vec3f> centroids(triangles.size());
+	Utilities::parallel_for(triangles.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const Vertex* vertices = triangles[i].vertices;
+			centroids[i] = (Vec3f(vertices[0].position) + Vec3f(vertices[1].position) + Vec3f(vertices[2].position))
+				* (1.f / 3.f);
+		}
+	}, 16384);
+	const std::vector<uint32_t> order = morton_order(centroids);
+
+	// moves the triangles along the cycles of the permutation, which avoids allocating and touching a second list
+	std::vector<bool> moved(order.size(), false);
+	for (size_t start = 0; start < order.size(); start++)
+	{
+		if (moved[start])
+			continue;
+		const Triangle first = triangles[start];
+		for (size_t i = start;;)
+		{
+			moved[i] = true;
+			const size_t source = order[i];
+			if (source == start)
+			{
+				triangles[i] = first;
+				break;
+			}
+			triangles[i] = triangles[source];
+			i = source;
+		}
+	}
+
+	if (!indices.empty())
+	{
+		std::vector<uint32_t> sorted_indices(indices.size());
+		Utilities::parallel_for(order.size(), [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				for (int corner = 0; corner < 3; corner++)
+					sorted_indices[3 * i + corner] = indices[3 * static_cast<size_t>(order[i]) + corner];
+			}
+		}, 16384);
+		indices.swap(sorted_indices);
+	}
+	return order;
+}
+
+std::vector<uint32_t> SpatialSort::sort_vertices(std::vector<uint32_t>& indices, std::vector<Vec3f>& positions)
+{
+	const uint32_t unused = 0xFFFFFFFF;
+	std::vector<uint32_t> remap(positions.size(), unused);
+	uint32_t next = 0;
+	for (uint32_t& index : indices)
+	{
+		if (index >= positions.size())
+			throw std::invalid_argument("'SpatialSort::sort_vertices' should only be called with valid vertex ids.");
+		if (remap[index] == unused)
+			remap[index] = next++;
+		index = remap[index];
+	}
+	for (uint32_t& id : remap)
+	{
+		if (id == unused)
+			id = next++;
+	}
+
+	std::vector<Vec3f> sorted_positions(positions.size());
+	for (size_t vertex = 0; vertex < positions.size(); vertex++)
+		sorted_positions[remap[vertex]] = positions[vertex];
+	positions.swap(sorted_positions);
+	return remap;
+}
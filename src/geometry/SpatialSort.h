@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/Vec3f.h"
+#include "primitives/Triangle.h"
+
+/* The number of bits per axis of the Morton codes of the spatial sort: */
+#define SPATIAL_SORT_MORTON_BITS 10
+
+/**
+ * \brief Reorders meshes along the Morton curve, so elements which are close in space are close in memory.
+ * Queries and mesh walks then touch fewer cache lines and pages, since neighbouring triangles share them.
+ */
+namespace SpatialSort
+{
+	/**
+	 * \brief Returns the order of points along the Morton curve through their bounding box.
+	 * Points in the same cell keep their order.
+	 * \param points The points.
+	 * \return The point ids in sorted order.
+	 */
+	std::vector<uint32_t> morton_order(const std::vector<Vec3f>& points);
+
+	/**
+	 * \brief Sorts triangles by the Morton codes of their centroids.
+	 * \param triangles The triangles.
+	 * \param indices The vertex ids of the triangles, which are moved along. (3 per triangle or empty)
+	 * \return The old triangle ids in the new order.
+	 */
+	std::vector<uint32_t> sort_triangles(std::vector<Triangle>& triangles, std::vector<uint32_t>& indices);
+
+	/**
+	 * \brief Renumbers the vertices in the order of their first use by the triangles.
+	 * After 'sort_triangles' the vertices are thereby sorted along the Morton curve as well.
+	 * Unused vertices are moved to the end.
+	 * \param indices The vertex ids. (3 per triangle)
+	 * \param positions The vertex positions.
+	 * \return The new id of each old vertex.
+	 */
+	std::vector<uint32_t> sort_vertices(std::vector<uint32_t>& indices, std::vector<Vec3f>& positions);
+}
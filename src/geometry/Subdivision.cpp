@@ -0,0 +1,189 @@
+#include "Subdivision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "utilities/Parallel.h"
+
+namespace
+{
+	/**
+	 * \brief The number of half-edges per chunk of the edge numbering.
+	 */
+	const uint32_t EDGE_CHUNK_SIZE = 4096;
+
+	/**
+	 * \brief Returns the position of an old vertex after one step.
+	 */
+	Vec3f even_position(const HalfEdgeMesh& mesh, uint32_t vertex)
+	{
+		const Vec3f position = mesh.position(vertex);
+		const uint32_t first = mesh.vertex_half_edge(vertex);
+		if (first == HalfEdgeMesh::INVALID)
+			return position;
+
+		// the boundary half-edge starts the rotation, which ends at the incoming boundary half-edge
+		if (mesh.is_boundary_edge(first))
+		{
+			uint32_t last = first;
+			for (uint32_t h = mesh.rotate(first); h != HalfEdgeMesh::INVALID; h = mesh.rotate(h))
+				last = h;
+			return position * 0.75f + (mesh.position(mesh.target(first)) + mesh.position(mesh.origin(HalfEdgeMesh::prev(last)))) * 0.125f;
+		}
+
+		Vec3f sum(0.f, 0.f, 0.f);
+		uint32_t valence = 0;
+		uint32_t h = first;
+		do
+		{
+			sum = sum + mesh.position(mesh.target(h));
+			valence++;
+			h = mesh.rotate(h);
+		} while (h != first && h != HalfEdgeMesh::INVALID);
+
+		const double cosine = 0.375 + 0.25 * std::cos(2.0 * 3.14159265358979323846 / valence);
+		const float beta = static_cast<float>((0.625 - cosine * cosine) / valence);
+		return position * (1.f - valence * beta) + sum * beta;
+	}
+
+	/**
+	 * \brief Returns the position of the new vertex on the edge of a half-edge.
+	 */
+	Vec3f odd_position(const HalfEdgeMesh& mesh, uint32_t half_edge)
+	{
+		const Vec3f a = mesh.position(mesh.origin(half_edge)), b = mesh.position(mesh.target(half_edge));
+		const uint32_t twin = mesh.twin(half_edge);
+		if (twin == HalfEdgeMesh::INVALID)
+			return (a + b) * 0.5f;
+
+		// the vertices opposite of the edge in both faces
+		const Vec3f c = mesh.position(mesh.origin(HalfEdgeMesh::prev(half_edge)));
+		const Vec3f d = mesh.position(mesh.origin(HalfEdgeMesh::prev(twin)));
+		return (a + b) * 0.375f + (c + d) * 0.125f;
+	}
+
+	/**
+	 * \brief Returns the half-edge of a child face which covers the first or the second half of an old half-edge.
+	 * The corner face 4f+c starts with the first half of the half-edge 3f+c and ends with the second half of 3f+c-1.
+	 */
+	uint32_t child_half_edge(uint32_t half_edge, bool second_half)
+	{
+		const uint32_t face = HalfEdgeMesh::face(half_edge), corner = half_edge % 3;
+		return second_half ? 3 * (4 * face + (corner + 1) % 3) + 2 : 3 * (4 * face + corner);
+	}
+
+	/**
+	 * \brief Subdivides a mesh once.
+	 */
+	HalfEdgeMesh loop_step(const HalfEdgeMesh& mesh)
+	{
+		const uint32_t face_count = mesh.face_count(), half_edge_count = mesh.half_edge_count();
+		const uint32_t vertex_count = mesh.vertex_count();
+		if (face_count > (HalfEdgeMesh::INVALID - 2) / 12)
+			throw std::invalid_argument("'Subdivision::loop' only supports 32 bit indices in the subdivided mesh.");
+
+		// each edge belongs to its boundary half-edge or the smaller one of its twins
+		const auto owns = [&mesh](uint32_t h)
+		{
+			const uint32_t twin = mesh.twin(h);
+			return twin == HalfEdgeMesh::INVALID || h < twin;
+		};
+
+		// numbers the edges in the order of the half-edges with a prefix sum over fixed chunks
+		const size_t chunk_count = (static_cast<size_t>(half_edge_count) + EDGE_CHUNK_SIZE - 1) / EDGE_CHUNK_SIZE;
+		std::vector<uint32_t> chunk_begins(chunk_count + 1, 0);
+		Utilities::parallel_for(chunk_count, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t chunk = begin; chunk < end; chunk++)
+			{
+				const uint32_t last = std::min<uint32_t>(static_cast<uint32_t>((chunk + 1) * EDGE_CHUNK_SIZE), half_edge_count);
+				for (uint32_t h = static_cast<uint32_t>(chunk * EDGE_CHUNK_SIZE); h < last; h++)
+					chunk_begins[chunk + 1] += owns(h);
+			}
+		}, 1);
+		for (size_t chunk = 0; chunk < chunk_count; chunk++)
+			chunk_begins[chunk + 1] += chunk_begins[chunk];
+		const uint32_t edge_count = chunk_begins[chunk_count];
+
+		// the new vertex of each half-edge, which follows the old vertices
+		std::vector<uint32_t> edge_vertices(half_edge_count);
+		Utilities::parallel_for(chunk_count, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t chunk = begin; chunk < end; chunk++)
+			{
+				uint32_t vertex = vertex_count + chunk_begins[chunk];
+				const uint32_t last = std::min<uint32_t>(static_cast<uint32_t>((chunk + 1) * EDGE_CHUNK_SIZE), half_edge_count);
+				for (uint32_t h = static_cast<uint32_t>(chunk * EDGE_CHUNK_SIZE); h < last; h++)
+				{
+					if (owns(h))
+						edge_vertices[h] = vertex++;
+				}
+			}
+		}, 1);
+		Utilities::parallel_for(half_edge_count, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t h = begin; h < end; h++)
+			{
+				if (!owns(static_cast<uint32_t>(h)))
+					edge_vertices[h] = edge_vertices[mesh.twin(static_cast<uint32_t>(h))];
+			}
+		}, 16384);
+
+		std::vector<Vec3f> positions(static_cast<size_t>(vertex_count) + edge_count);
+		Utilities::parallel_for(vertex_count, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t vertex = begin; vertex < end; vertex++)
+				positions[vertex] = even_position(mesh, static_cast<uint32_t>(vertex));
+		}, 4096);
+		Utilities::parallel_for(half_edge_count, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t h = begin; h < end; h++)
+			{
+				if (owns(static_cast<uint32_t>(h)))
+					positions[edge_vertices[h]] = odd_position(mesh, static_cast<uint32_t>(h));
+			}
+		}, 4096);
+
+		// the corner faces 4f+c = (v_c, m_c, m_c-1) and the center face 4f+3 = (m_0, m_1, m_2)
+		std::vector<uint32_t> indices(12 * static_cast<size_t>(face_count));
+		std::vector<uint32_t> twins(12 * static_cast<size_t>(face_count));
+		Utilities::parallel_for(face_count, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (uint32_t face = static_cast<uint32_t>(begin); face < end; face++)
+			{
+				const uint32_t center = 3 * (4 * face + 3);
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					const uint32_t h = HalfEdgeMesh::half_edge(face) + corner, previous = HalfEdgeMesh::prev(h);
+					const uint32_t child = 3 * (4 * face + corner);
+					indices[child] = mesh.origin(h);
+					indices[child + 1] = edge_vertices[h];
+					indices[child + 2] = edge_vertices[previous];
+					indices[center + corner] = edge_vertices[h];
+
+					// the halves of an edge meet the opposite halves of its twin
+					const uint32_t twin = mesh.twin(h), previous_twin = mesh.twin(previous);
+					twins[child] = twin == HalfEdgeMesh::INVALID ? HalfEdgeMesh::INVALID : child_half_edge(twin, true);
+					twins[child + 1] = center + (corner + 2) % 3;
+					twins[child + 2] = previous_twin == HalfEdgeMesh::INVALID ? HalfEdgeMesh::INVALID : child_half_edge(previous_twin, false);
+					twins[center + corner] = 3 * (4 * face + (corner + 1) % 3) + 1;
+				}
+			}
+		}, 4096);
+
+		return HalfEdgeMesh(std::move(indices), std::move(twins), std::move(positions));
+	}
+}
+
+HalfEdgeMesh Subdivision::loop(const HalfEdgeMesh& mesh, unsigned int levels)
+{
+	if (levels == 0)
+		return mesh;
+
+	HalfEdgeMesh result = loop_step(mesh);
+	for (unsigned int level = 1; level < levels; level++)
+		result = loop_step(result);
+	return result;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include "geometry/HalfEdgeMesh.h"
+
+/**
+ * \brief Refines triangle meshes with Loop subdivision. (Loop, Smooth Subdivision Surfaces Based on Triangles)
+ * Each level splits every face into 4 and inserts one vertex per edge, so the sizes of the next level are known
+ * in advance: all buffers are allocated once with their final size and filled in parallel, and the twins of the
+ * new half-edges follow from the old ones, so the edge table of the half-edge structure is not rebuilt.
+ */
+namespace Subdivision
+{
+	/**
+	 * \brief Subdivides a mesh on all threads. The old vertices keep their ids and the new vertex of an edge
+	 * follows them in the order of the half-edges. The face f becomes the faces 4f to 4f+3.
+	 * Boundary edges are subdivided as cubic B-splines, so the boundary curves stay independent of the interior.
+	 * \param mesh The mesh.
+	 * \param levels The number of subdivision steps.
+	 * \return The subdivided mesh.
+	 */
+	HalfEdgeMesh loop(const HalfEdgeMesh& mesh, unsigned int levels = 1);
+}
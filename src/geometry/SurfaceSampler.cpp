@@ -0,0 +1,132 @@
+#include "SurfaceSampler.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "utilities/Parallel.h"
+#include "utilities/Random.h"
+
+/* The number of triangles or samples per chunk of the parallel loops: */
+#define SURFACE_SAMPLER_GRAIN 16384
+
+SurfaceSampler::SurfaceSampler(const std::vector<Triangle>& triangles, uint64_t seed)
+	: triangles(triangles), stream(Utilities::random_stream(seed)), area(0.0)
+{
+	if (triangles.empty())
+		throw std::invalid_argument("'SurfaceSampler' should only be called with at least one triangle.");
+	if (triangles.size() >= 0xFFFFFFFFull)
+		throw std::invalid_argument("'SurfaceSampler' only supports 32 bit triangle ids.");
+
+	// the areas and the sums of fixed chunks, so the total does not depend on the number of threads
+	const size_t count = triangles.size();
+	std::vector<double> areas(count);
+	std::vector<double> chunk_areas((count + SURFACE_SAMPLER_GRAIN - 1) / SURFACE_SAMPLER_GRAIN, 0.0);
+	frames.resize(count);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			TriangleFrame& frame = frames[i];
+			frame.a = Vec3f(triangles[i].vertices[0].position);
+			frame.ab = Vec3f(triangles[i].vertices[1].position) - frame.a;
+			frame.ac = Vec3f(triangles[i].vertices[2].position) - frame.a;
+			areas[i] = 0.5 * frame.ab.cross(frame.ac).length();
+			chunk_areas[i / SURFACE_SAMPLER_GRAIN] += areas[i];
+		}
+	}, SURFACE_SAMPLER_GRAIN);
+	for (double chunk_area : chunk_areas)
+		area += chunk_area;
+
+	// scales the areas to a mean of 1 (all triangles are equally likely if there is no area at all)
+	const double scale = area > 0.0 ? static_cast<double>(count) / area : 0.0;
+	std::vector<uint32_t> small, large;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		areas[i] = area > 0.0 ? areas[i] * scale : 1.0;
+		(areas[i] < 1.0 ? small : large).push_back(i);
+	}
+
+	// pairs each triangle below the mean with one above it, which gives its remaining probability (Vose)
+	alias_table.resize(count);
+	while (!small.empty() && !large.empty())
+	{
+		const uint32_t less = small.back(), more = large.back();
+		small.pop_back();
+		alias_table[less].probability = static_cast<float>(areas[less]);
+		alias_table[less].alias = more;
+		areas[more] = (areas[more] + areas[less]) - 1.0;
+		if (areas[more] < 1.0)
+		{
+			large.pop_back();
+			small.push_back(more);
+		}
+	}
+	// the rest is 1 up to rounding errors
+	for (uint32_t i : small)
+		alias_table[i] = { 1.f, i };
+	for (uint32_t i : large)
+		alias_table[i] = { 1.f, i };
+}
+
+double SurfaceSampler::get_area() const
+{
+	return area;
+}
+
+SurfaceSample SurfaceSampler::sample(uint64_t index) const
+{
+	uint32_t triangle;
+	float s, t;
+	draw(index, triangle, s, t);
+	return { triangle, Barycentric(1.f - s, s * (1.f - t), s * t) };
+}
+
+void SurfaceSampler::sample(uint64_t first, size_t count, SurfaceSample* results) const
+{
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+			results[i] = sample(first + i);
+	}, SURFACE_SAMPLER_GRAIN);
+}
+
+void SurfaceSampler::sample_positions(uint64_t first, size_t count, Vec3f* positions) const
+{
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			uint32_t triangle;
+			float s, t;
+			draw(first + i, triangle, s, t);
+			const TriangleFrame& frame = frames[triangle];
+			positions[i] = frame.a + frame.ab * (s * (1.f - t)) + frame.ac * (s * t);
+		}
+	}, SURFACE_SAMPLER_GRAIN);
+}
+
+void SurfaceSampler::sample_vertices(uint64_t first, size_t count, Vertex* vertices) const
+{
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const SurfaceSample result = sample(first + i);
+			vertices[i] = triangles[result.triangle].interpolate(result.barycentric);
+		}
+	}, SURFACE_SAMPLER_GRAIN);
+}
+
+void SurfaceSampler::draw(uint64_t index, uint32_t& triangle, float& s, float& t) const
+{
+	// the upper 32 bits choose the entry, the lower 24 bits decide between it and its alias
+	const uint64_t bits = Utilities::random_bits(stream, index);
+	const uint32_t entry = static_cast<uint32_t>(((bits >> 32) * alias_table.size()) >> 32);
+	const AliasEntry& alias_entry = alias_table[entry];
+	triangle = Utilities::to_unit_float(bits) < alias_entry.probability ? entry : alias_entry.alias;
+
+	// the square root warp maps the unit square onto the triangle with a uniform density
+	const uint64_t warp_bits = Utilities::mix_bits(bits);
+	s = std::sqrt(Utilities::to_unit_float(warp_bits));
+	t = Utilities::to_unit_float(warp_bits >> 32);
+}
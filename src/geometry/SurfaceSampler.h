@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "math/Vec3f.h"
+#include "primitives/Barycentric.h"
+#include "primitives/Triangle.h"
+#include "primitives/Vertex.h"
+
+/**
+ * \brief A random point on a surface.
+ */
+struct SurfaceSample
+{
+	/**
+	 * \brief The id of the triangle.
+	 */
+	uint32_t triangle;
+
+	/**
+	 * \brief The barycentric coordinates in the triangle.
+	 */
+	Barycentric barycentric;
+};
+
+/**
+ * \brief Draws uniformly distributed random points on the surface of triangles.
+ * A triangle is chosen in proportion to its area with an alias table (Walker, Vose), a point in it with the
+ * square root warp of two uniform numbers. Sample i of a seed only depends on i, so any range of samples can
+ * be drawn on any thread with the same results.
+ */
+class SurfaceSampler
+{
+public:
+	/**
+	 * \brief The constructor. Builds the alias table.
+	 * \param triangles The triangles. (they have to outlive the sampler)
+	 * \param seed The seed of the random stream.
+	 */
+	explicit SurfaceSampler(const std::vector<Triangle>& triangles, uint64_t seed = 0);
+
+	/**
+	 * \brief Returns the total area of the triangles.
+	 * \return The area.
+	 */
+	double get_area() const;
+
+	/**
+	 * \brief Draws a sample of the random stream.
+	 * \param index The index of the sample in the stream.
+	 * \return The sample.
+	 */
+	SurfaceSample sample(uint64_t index) const;
+
+	/**
+	 * \brief Draws consecutive samples of the random stream on all threads.
+	 * \param first The index of the first sample in the stream.
+	 * \param count The number of samples.
+	 * \param results The samples.
+	 */
+	void sample(uint64_t first, size_t count, SurfaceSample* results) const;
+
+	/**
+	 * \brief Draws the positions of consecutive samples of the random stream on all threads.
+	 * \param first The index of the first sample in the stream.
+	 * \param count The number of samples.
+	 * \param positions The positions.
+	 */
+	void sample_positions(uint64_t first, size_t count, Vec3f* positions) const;
+
+	/**
+	 * \brief Draws consecutive samples of the random stream with all interpolated attributes on all threads.
+	 * \param first The index of the first sample in the stream.
+	 * \param count The number of samples.
+	 * \param vertices The vertices.
+	 */
+	void sample_vertices(uint64_t first, size_t count, Vertex* vertices) const;
+
+private:
+	/**
+	 * \brief An entry of the alias table. (8 bytes, so the lookup touches one cache line)
+	 */
+	struct AliasEntry
+	{
+		/**
+		 * \brief The probability to keep the triangle of the entry instead of taking the alias.
+		 */
+		float probability;
+
+		/**
+		 * \brief The other triangle of the entry.
+		 */
+		uint32_t alias;
+	};
+
+	/**
+	 * \brief The corner and the two edges of a triangle, which is all 'sample_positions' needs.
+	 */
+	struct TriangleFrame
+	{
+		Vec3f a, ab, ac;
+	};
+
+	/**
+	 * \brief Draws a sample of the random stream.
+	 * \param index The index of the sample in the stream.
+	 * \param triangle The triangle.
+	 * \param s The square root of the first uniform number.
+	 * \param t The second uniform number.
+	 */
+	void draw(uint64_t index, uint32_t& triangle, float& s, float& t) const;
+
+	/**
+	 * \brief The triangles.
+	 */
+	const std::vector<Triangle>& triangles;
+
+	/**
+	 * \brief The alias table. (one entry per triangle)
+	 */
+	std::vector<AliasEntry> alias_table;
+
+	/**
+	 * \brief The frames of the triangles.
+	 */
+	std::vector<TriangleFrame> frames;
+
+	/**
+	 * \brief The key of the random stream.
+	 */
+	uint64_t stream;
+
+	/**
+	 * \brief The total area.
+	 */
+	double area;
+};
@@ -0,0 +1,95 @@
+#include "TessellationPattern.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "utilities/Parallel.h"
+
+TessellationPattern::TessellationPattern(uint32_t level)
+	: level(level)
+{
+	if (level == 0 || level > 0xFFFF)
+		throw std::invalid_argument("'TessellationPattern' should only be created with levels 1-65535.");
+
+	// each weight is divided separately, so points on an edge do not depend on the third vertex
+	const float n = static_cast<float>(level);
+	barycentrics.reserve(vertex_count());
+	for (uint32_t row = 0; row <= level; row++)
+	{
+		for (uint32_t i = 0; i + row <= level; i++)
+			barycentrics.push_back(Barycentric(static_cast<float>(level - i - row) / n, static_cast<float>(i) / n, static_cast<float>(row) / n));
+	}
+
+	// the row j starts after the rows with N + 1, N, ... points
+	const auto point = [level](uint32_t i, uint32_t row)
+	{
+		return row * (level + 1) - row * (row - 1) / 2 + i;
+	};
+	indices.reserve(3 * static_cast<size_t>(triangle_count()));
+	for (uint32_t row = 0; row < level; row++)
+	{
+		for (uint32_t i = 0; i + row < level; i++)
+		{
+			indices.insert(indices.end(), { point(i, row), point(i + 1, row), point(i, row + 1) });
+			if (i + row + 1 < level)
+				indices.insert(indices.end(), { point(i + 1, row), point(i + 1, row + 1), point(i, row + 1) });
+		}
+	}
+}
+
+uint32_t TessellationPattern::get_level() const
+{
+	return level;
+}
+
+uint32_t TessellationPattern::vertex_count() const
+{
+	return (level + 1) * (level + 2) / 2;
+}
+
+uint32_t TessellationPattern::triangle_count() const
+{
+	return level * level;
+}
+
+const std::vector<Barycentric>& TessellationPattern::get_barycentrics() const
+{
+	return barycentrics;
+}
+
+const std::vector<uint32_t>& TessellationPattern::get_indices() const
+{
+	return indices;
+}
+
+void TessellationPattern::tessellate(const std::vector<Triangle>& triangles, Vertex* vertices) const
+{
+	const size_t points = barycentrics.size();
+	Utilities::parallel_for(triangles.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t triangle = begin; triangle < end; triangle++)
+		{
+			Vertex* output = vertices + triangle * points;
+			for (size_t i = 0; i < points; i++)
+				output[i] = triangles[triangle].interpolate(barycentrics[i]);
+		}
+	}, std::max<size_t>(1, 16384 / points));
+}
+
+void TessellationPattern::tessellate(const std::vector<Triangle>& triangles, Triangle* output) const
+{
+	const size_t points = barycentrics.size(), count = triangle_count();
+	Utilities::parallel_for(triangles.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		// the points of one triangle, reused for all triangles of the chunk
+		std::vector<Vertex> vertices(points);
+		for (size_t triangle = begin; triangle < end; triangle++)
+		{
+			for (size_t i = 0; i < points; i++)
+				vertices[i] = triangles[triangle].interpolate(barycentrics[i]);
+			Triangle* result = output + triangle * count;
+			for (size_t i = 0; i < count; i++)
+				result[i] = Triangle(vertices[indices[3 * i]], vertices[indices[3 * i + 1]], vertices[indices[3 * i + 2]]);
+		}
+	}, std::max<size_t>(1, 16384 / points));
+}
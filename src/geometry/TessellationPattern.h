@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "primitives/Barycentric.h"
+#include "primitives/Triangle.h"
+
+/**
+ * \brief The uniform barycentric tessellation of a triangle at a level N, which splits each edge into N segments
+ * and the triangle into N^2 triangles. The sample points and the triangles are computed once and shared by all
+ * triangles, so tessellating a mesh only interpolates the vertices and writes them to buffers of a known size.
+ * The weights of a point on an edge only depend on its position along the edge, so neighbouring triangles which
+ * share the vertices of an edge get exactly the same points there and the tessellated mesh stays watertight.
+ */
+class TessellationPattern
+{
+public:
+	/**
+	 * \brief The constructor.
+	 * \param level The number of segments per edge. (at least 1)
+	 */
+	explicit TessellationPattern(uint32_t level);
+
+	/**
+	 * \brief Returns the number of segments per edge.
+	 * \return The level.
+	 */
+	uint32_t get_level() const;
+
+	/**
+	 * \brief Returns the number of sample points per triangle. ((N + 1) * (N + 2) / 2)
+	 * \return The number of points.
+	 */
+	uint32_t vertex_count() const;
+
+	/**
+	 * \brief Returns the number of triangles per triangle. (N^2)
+	 * \return The number of triangles.
+	 */
+	uint32_t triangle_count() const;
+
+	/**
+	 * \brief Returns the barycentric coordinates of the sample points row by row, from the edge between the first
+	 * and the second vertex towards the third vertex.
+	 * \return The barycentric coordinates.
+	 */
+	const std::vector<Barycentric>& get_barycentrics() const;
+
+	/**
+	 * \brief Returns the sample points of the triangles with the orientation of the tessellated triangle.
+	 * \return The point ids. (3 per triangle)
+	 */
+	const std::vector<uint32_t>& get_indices() const;
+
+	/**
+	 * \brief Interpolates the sample points of all triangles on all threads.
+	 * Together with 'get_indices' (offset by the first point of each triangle) this is an indexed mesh.
+	 * \param triangles The triangles.
+	 * \param vertices The preallocated points. ('vertex_count' per triangle, in the order of the triangles)
+	 */
+	void tessellate(const std::vector<Triangle>& triangles, Vertex* vertices) const;
+
+	/**
+	 * \brief Tessellates all triangles on all threads.
+	 * \param triangles The triangles.
+	 * \param output The preallocated triangles. ('triangle_count' per triangle, in the order of the triangles)
+	 */
+	void tessellate(const std::vector<Triangle>& triangles, Triangle* output) const;
+
+private:
+	/**
+	 * \brief The number of segments per edge.
+	 */
+	uint32_t level;
+
+	/**
+	 * \brief The barycentric coordinates of the sample points.
+	 */
+	std::vector<Barycentric> barycentrics;
+
+	/**
+	 * \brief The point ids of the triangles.
+	 */
+	std::vector<uint32_t> indices;
+};
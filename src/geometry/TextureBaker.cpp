@@ -0,0 +1,391 @@
+#include "TextureBaker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+#include "geometry/RayQuery.h"
+#include "utilities/Parallel.h"
+#include "utilities/Random.h"
+
+// Include stb
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+/* The number of fractional bits of the fixed point texel coordinates: (exact edge functions keep shared edges watertight) */
+#define TEXTURE_BAKER_SUBPIXEL_BITS 8
+
+/* The offset of the ambient occlusion rays from the surface in diagonals of the bounds: */
+#define TEXTURE_BAKER_RAY_OFFSET 1e-4f
+
+namespace
+{
+	/**
+	 * \brief Returns the bounds of the positions of triangles.
+	 * \param triangles The triangles.
+	 * \param min The minimum.
+	 * \param max The maximum.
+	 */
+	void bounds(const std::vector<Triangle>& triangles, Vec3f& min, Vec3f& max)
+	{
+		min = Vec3f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+		max = -min;
+		for (const Triangle& triangle : triangles)
+		{
+			for (const Vertex& vertex : triangle.vertices)
+			{
+				min = Vec3f::min(min, Vec3f(vertex.position));
+				max = Vec3f::max(max, Vec3f(vertex.position));
+			}
+		}
+	}
+
+	/**
+	 * \brief Returns the face normal of a triangle, oriented like an interpolated vertex normal.
+	 * \param triangle The triangle.
+	 * \param normal The interpolated vertex normal. (zero keeps the winding order)
+	 * \return The unit normal. (zero for degenerate triangles)
+	 */
+	Vec3f face_normal(const Triangle& triangle, Vec3f normal)
+	{
+		const Vec3f a(triangle.vertices[0].position), b(triangle.vertices[1].position), c(triangle.vertices[2].position);
+		const Vec3f face = (b - a).cross(c - a);
+		const float length = face.length();
+		if (length == 0.f)
+			return face;
+		return face * ((face.dot(normal) < 0.f ? -1.f : 1.f) / length);
+	}
+
+	/**
+	 * \brief The range of texels whose centers are within the bounds of a triangle. (empty if min > max)
+	 */
+	struct TexelRange
+	{
+		int64_t min_x, min_y, max_x, max_y;
+	};
+}
+
+const uint32_t TextureBaker::NO_TRIANGLE;
+
+TextureBaker::TextureBaker(const std::vector<Triangle>& triangles, uint32_t width, uint32_t height)
+	: triangles(triangles), width(width), height(height)
+{
+	if (width == 0 || height == 0 || width > 65536 || height > 65536)
+		throw std::invalid_argument("'TextureBaker' should only be called with resolutions of 1-65536.");
+	BakedTexel empty;
+	empty.triangle = NO_TRIANGLE;
+	texels.assign(static_cast<size_t>(width) * height, empty);
+
+	// snaps the texture coordinates to fixed point texels, clamped far outside of the texture so the products fit
+	const int64_t one = int64_t(1) << TEXTURE_BAKER_SUBPIXEL_BITS;
+	const float limit = static_cast<float>(int64_t(1) << 28);
+	std::vector<int64_t> corners(6 * triangles.size());
+	std::vector<TexelRange> ranges(triangles.size());
+	Utilities::parallel_for(triangles.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			int64_t* x = &corners[6 * i];
+			int64_t* y = x + 3;
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const TexCoord uv = triangles[i].vertices[corner].uv;
+				x[corner] = static_cast<int64_t>(std::round(std::max(-limit, std::min(limit, uv.u * width * one))));
+				y[corner] = static_cast<int64_t>(std::round(std::max(-limit, std::min(limit, uv.v * height * one))));
+			}
+
+			// texel x has its center at (x + 0.5) * one
+			TexelRange& range = ranges[i];
+			range.min_x = std::max<int64_t>(0, (std::min({ x[0], x[1], x[2] }) + one / 2 - 1) >> TEXTURE_BAKER_SUBPIXEL_BITS);
+			range.min_y = std::max<int64_t>(0, (std::min({ y[0], y[1], y[2] }) + one / 2 - 1) >> TEXTURE_BAKER_SUBPIXEL_BITS);
+			range.max_x = std::min<int64_t>(width - 1, (std::max({ x[0], x[1], x[2] }) - one / 2) >> TEXTURE_BAKER_SUBPIXEL_BITS);
+			range.max_y = std::min<int64_t>(height - 1, (std::max({ y[0], y[1], y[2] }) - one / 2) >> TEXTURE_BAKER_SUBPIXEL_BITS);
+		}
+	}, 4096);
+
+	// bins the triangles into the tiles they overlap, each tile keeps them in the order of their ids
+	const uint32_t tiles_x = (width + TEXTURE_BAKER_TILE_SIZE - 1) / TEXTURE_BAKER_TILE_SIZE;
+	const uint32_t tiles_y = (height + TEXTURE_BAKER_TILE_SIZE - 1) / TEXTURE_BAKER_TILE_SIZE;
+	std::vector<uint32_t> tile_begins(static_cast<size_t>(tiles_x) * tiles_y + 1, 0);
+	std::vector<uint32_t> tile_triangles;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (uint32_t i = 0; i < triangles.size(); i++)
+		{
+			const TexelRange& range = ranges[i];
+			if (range.min_x > range.max_x || range.min_y > range.max_y)
+				continue;
+			for (int64_t tile_y = range.min_y / TEXTURE_BAKER_TILE_SIZE; tile_y <= range.max_y / TEXTURE_BAKER_TILE_SIZE; tile_y++)
+			{
+				for (int64_t tile_x = range.min_x / TEXTURE_BAKER_TILE_SIZE; tile_x <= range.max_x / TEXTURE_BAKER_TILE_SIZE; tile_x++)
+				{
+					const size_t tile = static_cast<size_t>(tile_y * tiles_x + tile_x);
+					if (pass == 0)
+						tile_begins[tile + 1]++;
+					else
+						tile_triangles[tile_begins[tile]++] = i;
+				}
+			}
+		}
+		if (pass == 0)
+		{
+			for (size_t tile = 1; tile < tile_begins.size(); tile++)
+				tile_begins[tile] += tile_begins[tile - 1];
+			tile_triangles.resize(tile_begins.back());
+		}
+	}
+	// the fill moved each begin to the end of its tile, which is the begin of the next one
+	for (size_t tile = tile_begins.size() - 1; tile > 0; tile--)
+		tile_begins[tile] = tile_begins[tile - 1];
+	tile_begins[0] = 0;
+
+	Utilities::parallel_for(tile_begins.size() - 1, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t tile = begin; tile < end; tile++)
+		{
+			const int64_t tile_min_x = static_cast<int64_t>(tile % tiles_x) * TEXTURE_BAKER_TILE_SIZE;
+			const int64_t tile_min_y = static_cast<int64_t>(tile / tiles_x) * TEXTURE_BAKER_TILE_SIZE;
+			for (uint32_t t = tile_begins[tile]; t < tile_begins[tile + 1]; t++)
+			{
+				const uint32_t id = tile_triangles[t];
+				const int64_t* x = &corners[6 * static_cast<size_t>(id)];
+				const int64_t* y = x + 3;
+
+				// the corners in counter clockwise order, mirrored charts are flipped
+				int order[3] = { 0, 1, 2 };
+				const int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+				if (area == 0)
+					continue;
+				if (area < 0)
+					std::swap(order[1], order[2]);
+				const float inverse_area = 1.f / static_cast<float>(std::abs(area));
+
+				// the edge function of the edge opposite of each corner is e = a * x + b * y + c, positive inside
+				int64_t a[3], b[3], c[3], bias[3];
+				for (int i = 0; i < 3; i++)
+				{
+					const int from = order[(i + 1) % 3], to = order[(i + 2) % 3];
+					a[i] = y[from] - y[to];
+					b[i] = x[to] - x[from];
+					c[i] = x[from] * y[to] - y[from] * x[to];
+					// top-left rule: only one of the two triangles of a shared edge covers texel centers on it
+					bias[i] = (a[i] < 0 || (a[i] == 0 && b[i] < 0)) ? 0 : 1;
+				}
+
+				const TexelRange& range = ranges[id];
+				const int64_t min_x = std::max(range.min_x, tile_min_x);
+				const int64_t max_x = std::min(range.max_x, tile_min_x + TEXTURE_BAKER_TILE_SIZE - 1);
+				const int64_t min_y = std::max(range.min_y, tile_min_y);
+				const int64_t max_y = std::min(range.max_y, tile_min_y + TEXTURE_BAKER_TILE_SIZE - 1);
+				for (int64_t texel_y = min_y; texel_y <= max_y; texel_y++)
+				{
+					const int64_t center_x = min_x * one + one / 2, center_y = texel_y * one + one / 2;
+					int64_t e[3];
+					for (int i = 0; i < 3; i++)
+						e[i] = a[i] * center_x + b[i] * center_y + c[i];
+					BakedTexel* row = &texels[static_cast<size_t>(texel_y) * width];
+					for (int64_t texel_x = min_x; texel_x <= max_x; texel_x++)
+					{
+						if (e[0] >= bias[0] && e[1] >= bias[1] && e[2] >= bias[2])
+						{
+							float weights[3];
+							for (int i = 0; i < 3; i++)
+								weights[order[i]] = static_cast<float>(e[i]) * inverse_area;
+							row[texel_x].triangle = id;
+							row[texel_x].barycentric = Barycentric(weights[0], weights[1], weights[2]);
+						}
+						for (int i = 0; i < 3; i++)
+							e[i] += a[i] * one;
+					}
+				}
+			}
+		}
+	}, 1);
+}
+
+uint32_t TextureBaker::get_width() const
+{
+	return width;
+}
+
+uint32_t TextureBaker::get_height() const
+{
+	return height;
+}
+
+const BakedTexel& TextureBaker::get_texel(uint32_t x, uint32_t y) const
+{
+	return texels[static_cast<size_t>(y) * width + x];
+}
+
+const std::vector<BakedTexel>& TextureBaker::get_texels() const
+{
+	return texels;
+}
+
+template <typename Function>
+std::vector<Vec4f> TextureBaker::bake(Function function, size_t grain) const
+{
+	std::vector<Vec4f> map(texels.size(), Vec4f(0, 0, 0, 0));
+	Utilities::parallel_for(texels.size(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			if (texels[i].triangle == NO_TRIANGLE)
+				continue;
+			const Vec3f value = function(i, triangles[texels[i].triangle].interpolate(texels[i].barycentric));
+			map[i] = Vec4f(value.x, value.y, value.z, 1);
+		}
+	}, grain);
+	return map;
+}
+
+std::vector<Vec4f> TextureBaker::bake_normals() const
+{
+	return bake([&](size_t i, const Vertex& vertex)
+	{
+		Vec3f normal(vertex.normal);
+		const float length = normal.length();
+		normal = length > 0.f ? normal * (1.f / length) : face_normal(triangles[texels[i].triangle], normal);
+		return normal * 0.5f + Vec3f(0.5f, 0.5f, 0.5f);
+	}, 16384);
+}
+
+std::vector<Vec4f> TextureBaker::bake_positions() const
+{
+	Vec3f min, max;
+	bounds(triangles, min, max);
+	const Vec3f extent = max - min;
+	const Vec3f scale(extent.x > 0.f ? 1.f / extent.x : 0.f, extent.y > 0.f ? 1.f / extent.y : 0.f, extent.z > 0.f ? 1.f / extent.z : 0.f);
+	return bake([&](size_t, const Vertex& vertex)
+	{
+		const Vec3f position = Vec3f(vertex.position) - min;
+		return Vec3f(position.x * scale.x, position.y * scale.y, position.z * scale.z);
+	}, 16384);
+}
+
+std::vector<Vec4f> TextureBaker::bake_occlusion(const BVH& bvh, uint32_t sample_count, float max_distance, uint64_t seed) const
+{
+	if (sample_count == 0)
+		throw std::invalid_argument("'TextureBaker::bake_occlusion' should only be called with at least one sample.");
+	Vec3f min, max;
+	bounds(triangles, min, max);
+	const float offset = TEXTURE_BAKER_RAY_OFFSET * (max - min).length();
+	const RayQuery query(bvh);
+	const uint64_t stream = Utilities::random_stream(seed);
+
+	return bake([&](size_t i, const Vertex& vertex)
+	{
+		// the rays start above the face, so they do not hit the triangle of the texel
+		const Vec3f normal = face_normal(triangles[texels[i].triangle], Vec3f(vertex.normal));
+		if (normal.squaredLength() == 0.f)
+			return Vec3f(1.f, 1.f, 1.f);
+		const Vec4f origin = (Vec3f(vertex.position) + normal * offset).toPoint();
+
+		// an orthonormal basis around the normal (Duff et al., Building an Orthonormal Basis, Revisited)
+		const float sign = std::copysign(1.f, normal.z);
+		const float a = -1.f / (sign + normal.z);
+		const float b = normal.x * normal.y * a;
+		const Vec3f tangent(1.f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+		const Vec3f bitangent(b, sign + normal.y * normal.y * a, -normal.y);
+
+		uint32_t open = 0;
+		for (uint32_t sample = 0; sample < sample_count; sample++)
+		{
+			// cosine weighted directions, 24 bits for each of the two numbers
+			const uint64_t bits = Utilities::random_bits(stream, i * sample_count + sample);
+			const float u = Utilities::to_unit_float(bits), v = Utilities::to_unit_float(bits >> 24);
+			const float radius = std::sqrt(u), angle = 6.28318530718f * v;
+			const Vec3f direction = tangent * (radius * std::cos(angle)) + bitangent * (radius * std::sin(angle))
+				+ normal * std::sqrt(std::max(0.f, 1.f - u));
+			if (!query.occluded(Ray(origin, direction.toVector()), max_distance))
+				open++;
+		}
+		const float occlusion = static_cast<float>(open) / static_cast<float>(sample_count);
+		return Vec3f(occlusion, occlusion, occlusion);
+	}, 64);
+}
+
+void TextureBaker::dilate(std::vector<Vec4f>& map, uint32_t gutter) const
+{
+	if (map.size() != texels.size())
+		throw std::invalid_argument("'TextureBaker::dilate' should only be called with maps of the size of the texture.");
+
+	std::vector<uint8_t> filled(texels.size()), next_filled(texels.size());
+	for (size_t i = 0; i < texels.size(); i++)
+		filled[i] = texels[i].triangle != NO_TRIANGLE;
+	std::vector<Vec4f> next = map;
+
+	for (uint32_t step = 0; step < gutter; step++)
+	{
+		std::atomic<bool> changed(false);
+		Utilities::parallel_for(height, [&](size_t begin, size_t end, unsigned int)
+		{
+			bool chunk_changed = false;
+			for (size_t y = begin; y < end; y++)
+			{
+				for (size_t x = 0; x < width; x++)
+				{
+					const size_t i = y * width + x;
+					next_filled[i] = filled[i];
+					if (filled[i])
+						continue;
+
+					// the average of the filled texels in the 3x3 neighbourhood
+					Vec3f sum(0.f, 0.f, 0.f);
+					float alpha = 0.f;
+					int count = 0;
+					for (size_t ny = y > 0 ? y - 1 : 0; ny <= std::min<size_t>(y + 1, height - 1); ny++)
+					{
+						for (size_t nx = x > 0 ? x - 1 : 0; nx <= std::min<size_t>(x + 1, width - 1); nx++)
+						{
+							const size_t n = ny * width + nx;
+							if (!filled[n])
+								continue;
+							sum = sum + Vec3f(map[n]);
+							alpha += map[n].w;
+							count++;
+						}
+					}
+					if (count == 0)
+						continue;
+					const float weight = 1.f / static_cast<float>(count);
+					next[i] = Vec4f(sum.x * weight, sum.y * weight, sum.z * weight, alpha * weight);
+					next_filled[i] = 1;
+					chunk_changed = true;
+				}
+			}
+			if (chunk_changed)
+				changed = true;
+		}, 16);
+		if (!changed)
+			break;
+		std::copy(next.begin(), next.end(), map.begin());
+		filled.swap(next_filled);
+	}
+}
+
+bool TextureBaker::save_png(const std::vector<Vec4f>& map, const std::string& path) const
+{
+	if (map.size() != texels.size())
+		throw std::invalid_argument("'TextureBaker::save_png' should only be called with maps of the size of the texture.");
+
+	// images start with the top row, which is at v = 1
+	std::vector<uint8_t> pixels(4 * map.size());
+	Utilities::parallel_for(height, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t y = begin; y < end; y++)
+		{
+			const Vec4f* row = &map[(height - 1 - y) * width];
+			uint8_t* pixel = &pixels[4 * y * width];
+			for (size_t x = 0; x < width; x++)
+			{
+				for (int channel = 0; channel < 4; channel++)
+					*pixel++ = static_cast<uint8_t>(std::max(0.f, std::min(1.f, row[x][channel])) * 255.f + 0.5f);
+			}
+		}
+	}, 64);
+	return stbi_write_png(path.c_str(), static_cast<int>(width), static_cast<int>(height), 4, pixels.data(),
+		static_cast<int>(4 * width)) != 0;
+}
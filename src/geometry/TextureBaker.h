@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "geometry/BVH.h"
+#include "primitives/Barycentric.h"
+#include "primitives/Triangle.h"
+
+/* The edge length of the square tiles of texels which are distributed over the threads: */
+#define TEXTURE_BAKER_TILE_SIZE 32
+
+/**
+ * \brief The surface point which a texel of a baked texture shows.
+ */
+struct BakedTexel
+{
+	/**
+	 * \brief The id of the triangle. ('TextureBaker::NO_TRIANGLE' for gutter texels)
+	 */
+	uint32_t triangle;
+
+	/**
+	 * \brief The barycentric coordinates of the texel center in the triangle.
+	 */
+	Barycentric barycentric;
+};
+
+/**
+ * \brief Bakes surface attributes into textures by rasterizing the triangles in their texture space on the CPU.
+ * The texture is split into tiles, which are processed in parallel. Each tile only visits the triangles whose
+ * bounds overlap it and tests its texel centers against the edge functions of the triangles. Shared edges follow
+ * the top-left rule, so no texel is covered twice by neighbouring triangles. Where triangles overlap in texture
+ * space the one with the higher id wins.
+ * Row 0 of the maps is at v = 0, so the rows are flipped when they are written as images.
+ */
+class TextureBaker
+{
+public:
+	/**
+	 * \brief The triangle id of texels which no triangle covers.
+	 */
+	static const uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+	/**
+	 * \brief The constructor. Rasterizes the triangles on all threads.
+	 * \param triangles The triangles. (e.g. of 'Mesh::get_triangles', they have to outlive the baker)
+	 * \param width The number of texels along u.
+	 * \param height The number of texels along v.
+	 */
+	TextureBaker(const std::vector<Triangle>& triangles, uint32_t width, uint32_t height);
+
+	/**
+	 * \brief Returns the number of texels along u.
+	 * \return The width.
+	 */
+	uint32_t get_width() const;
+
+	/**
+	 * \brief Returns the number of texels along v.
+	 * \return The height.
+	 */
+	uint32_t get_height() const;
+
+	/**
+	 * \brief Returns a texel.
+	 * \param x The column.
+	 * \param y The row.
+	 * \return The texel.
+	 */
+	const BakedTexel& get_texel(uint32_t x, uint32_t y) const;
+
+	/**
+	 * \brief Returns all texels. (row by row)
+	 * \return The texels.
+	 */
+	const std::vector<BakedTexel>& get_texels() const;
+
+	/**
+	 * \brief Bakes the interpolated object space normals, mapped from [-1, 1] to [0, 1].
+	 * Triangles without vertex normals use their face normal. The alpha is 1 for covered texels and 0 in the gutter.
+	 * \return The normal map. (row by row)
+	 */
+	std::vector<Vec4f> bake_normals() const;
+
+	/**
+	 * \brief Bakes the interpolated positions, mapped from the bounds of the triangles to [0, 1].
+	 * The alpha is 1 for covered texels and 0 in the gutter.
+	 * \return The position map. (row by row)
+	 */
+	std::vector<Vec4f> bake_positions() const;
+
+	/**
+	 * \brief Bakes the ambient occlusion with cosine weighted rays over the hemisphere of the normals.
+	 * The value is the fraction of rays which hit nothing within the maximum distance. (1 is unoccluded)
+	 * \param bvh The bounding volume hierarchy of the occluders. (e.g. of the same triangles)
+	 * \param sample_count The number of rays per texel.
+	 * \param max_distance The maximum distance of the occluders.
+	 * \param seed The seed of the ray directions.
+	 * \return The occlusion map. (row by row, alpha as in 'bake_normals')
+	 */
+	std::vector<Vec4f> bake_occlusion(const BVH& bvh, uint32_t sample_count,
+		float max_distance = std::numeric_limits<float>::infinity(), uint64_t seed = 0) const;
+
+	/**
+	 * \brief Fills the gutter around the covered texels, so filtering does not blend in the background.
+	 * Each step gives the empty texels next to filled ones the average of their filled neighbours.
+	 * \param map The map. (row by row)
+	 * \param gutter The number of steps.
+	 */
+	void dilate(std::vector<Vec4f>& map, uint32_t gutter) const;
+
+	/**
+	 * \brief Writes a map as a PNG image with 8 bits per channel. (clamped to [0, 1])
+	 * \param map The map. (row by row)
+	 * \param path The file path.
+	 * \return Whether the file was written.
+	 */
+	bool save_png(const std::vector<Vec4f>& map, const std::string& path) const;
+
+private:
+	/**
+	 * \brief Evaluates a function for all covered texels on all threads.
+	 * \param function The function. (texel index, vertex at the texel center)
+	 * \param grain The number of texels per chunk.
+	 * \return The map with the results of the function.
+	 */
+	template <typename Function>
+	std::vector<Vec4f> bake(Function function, size_t grain) const;
+
+	/**
+	 * \brief The triangles.
+	 */
+	const std::vector<Triangle>& triangles;
+
+	/**
+	 * \brief The number of texels along u.
+	 */
+	uint32_t width;
+
+	/**
+	 * \brief The number of texels along v.
+	 */
+	uint32_t height;
+
+	/**
+	 * \brief The texels. (row by row)
+	 */
+	std::vector<BakedTexel> texels;
+};
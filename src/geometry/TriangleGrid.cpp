@@ -0,0 +1,169 @@
+#include "TriangleGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "utilities/Parallel.h"
+
+/* Points on the edges are accepted up to this barycentric tolerance: */
+#define TRIANGLE_GRID_EPSILON 1e-6f
+
+TriangleGrid::TriangleGrid(const std::vector<Triangle>& triangles, float cells_per_triangle)
+{
+	std::vector<float> coordinates(6 * triangles.size());
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		for (int v = 0; v < 3; v++)
+		{
+			coordinates[6 * i + 2 * v + 0] = triangles[i].vertices[v].position.x;
+			coordinates[6 * i + 2 * v + 1] = triangles[i].vertices[v].position.y;
+		}
+	}
+	build(coordinates.data(), triangles.size(), cells_per_triangle);
+}
+
+TriangleGrid::TriangleGrid(const float* coordinates, size_t count, float cells_per_triangle)
+{
+	build(coordinates, count, cells_per_triangle);
+}
+
+void TriangleGrid::build(const float* coordinates, size_t count, float cells_per_triangle)
+{
+	// bounds of all triangles
+	float max_x = -std::numeric_limits<float>::max(), max_y = -std::numeric_limits<float>::max();
+	min_x = std::numeric_limits<float>::max();
+	min_y = std::numeric_limits<float>::max();
+	for (size_t i = 0; i < 3 * count; i++)
+	{
+		min_x = std::min(min_x, coordinates[2 * i]);
+		max_x = std::max(max_x, coordinates[2 * i]);
+		min_y = std::min(min_y, coordinates[2 * i + 1]);
+		max_y = std::max(max_y, coordinates[2 * i + 1]);
+	}
+	if (count == 0)
+	{
+		min_x = min_y = max_x = max_y = 0.f;
+	}
+
+	// square cells, so that the total number of cells is about cells_per_triangle * count
+	const float width = max_x - min_x, height = max_y - min_y;
+	const float cells = std::max(1.f, cells_per_triangle * count);
+	float cell_size = std::sqrt(width * height / cells);
+	if (cell_size <= 0.f)
+		cell_size = std::max(width, height) / cells;
+	if (cell_size <= 0.f)
+		cell_size = 1.f;
+	resolution_x = std::max(1, std::min(static_cast<int>(std::ceil(width / cell_size)), static_cast<int>(cells)));
+	resolution_y = std::max(1, std::min(static_cast<int>(std::ceil(height / cell_size)), static_cast<int>(cells)));
+	scale_x = width > 0.f ? resolution_x / width : 0.f;
+	scale_y = height > 0.f ? resolution_y / height : 0.f;
+
+	// the cell range of the bounding box of a triangle
+	const auto cell_range = [&](size_t i, int range[4])
+	{
+		const float* c = &coordinates[6 * i];
+		const float x0 = std::min({ c[0], c[2], c[4] }), x1 = std::max({ c[0], c[2], c[4] });
+		const float y0 = std::min({ c[1], c[3], c[5] }), y1 = std::max({ c[1], c[3], c[5] });
+		range[0] = std::min(static_cast<int>((x0 - min_x) * scale_x), resolution_x - 1);
+		range[1] = std::min(static_cast<int>((x1 - min_x) * scale_x), resolution_x - 1);
+		range[2] = std::min(static_cast<int>((y0 - min_y) * scale_y), resolution_y - 1);
+		range[3] = std::min(static_cast<int>((y1 - min_y) * scale_y), resolution_y - 1);
+	};
+
+	// counting sort of the triangle ids into the cells
+	cell_offsets.assign(static_cast<size_t>(resolution_x) * resolution_y + 1, 0);
+	for (size_t i = 0; i < count; i++)
+	{
+		int range[4];
+		cell_range(i, range);
+		for (int y = range[2]; y <= range[3]; y++)
+			for (int x = range[0]; x <= range[1]; x++)
+				cell_offsets[static_cast<size_t>(y) * resolution_x + x + 1]++;
+	}
+	for (size_t cell = 1; cell < cell_offsets.size(); cell++)
+		cell_offsets[cell] += cell_offsets[cell - 1];
+
+	cell_triangles.resize(cell_offsets.back());
+	std::vector<uint32_t> cursors(cell_offsets.begin(), cell_offsets.end() - 1);
+	for (size_t i = 0; i < count; i++)
+	{
+		int range[4];
+		cell_range(i, range);
+		for (int y = range[2]; y <= range[3]; y++)
+			for (int x = range[0]; x <= range[1]; x++)
+				cell_triangles[cursors[static_cast<size_t>(y) * resolution_x + x]++] = static_cast<uint32_t>(i);
+	}
+
+	// barycentric coordinates as affine functions of the point
+	coefficients.resize(6 * count);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const float* c = &coordinates[6 * i];
+			const double xa = c[0], ya = c[1], xb = c[2], yb = c[3], xc = c[4], yc = c[5];
+			const double det = (yb - yc) * (xa - xc) + (xc - xb) * (ya - yc);
+			float* k = &coefficients[6 * i];
+			if (det == 0.0)
+			{
+				// degenerate triangles never contain a point
+				k[0] = std::numeric_limits<float>::infinity();
+				k[1] = k[2] = k[3] = k[4] = k[5] = 0.f;
+				continue;
+			}
+			k[0] = c[4];
+			k[1] = c[5];
+			k[2] = static_cast<float>((yb - yc) / det);
+			k[3] = static_cast<float>((xc - xb) / det);
+			k[4] = static_cast<float>((yc - ya) / det);
+			k[5] = static_cast<float>((xa - xc) / det);
+		}
+	}, 4096);
+}
+
+bool TriangleGrid::locate(float x, float y, PointLocation& result) const
+{
+	result.triangle = NO_TRIANGLE;
+
+	const float gx = (x - min_x) * scale_x, gy = (y - min_y) * scale_y;
+	if (!(gx >= 0.f && gy >= 0.f && gx <= resolution_x && gy <= resolution_y)) return false;
+	const size_t cell = static_cast<size_t>(std::min(static_cast<int>(gy), resolution_y - 1)) * resolution_x
+		+ std::min(static_cast<int>(gx), resolution_x - 1);
+
+	// evaluates all candidates without branches and keeps the one the point lies deepest in
+	float best = -TRIANGLE_GRID_EPSILON;
+	uint32_t best_triangle = NO_TRIANGLE;
+	float best_alpha = 0.f, best_beta = 0.f;
+	for (uint32_t i = cell_offsets[cell]; i < cell_offsets[cell + 1]; i++)
+	{
+		const uint32_t triangle = cell_triangles[i];
+		const float* k = &coefficients[6 * static_cast<size_t>(triangle)];
+		const float dx = x - k[0], dy = y - k[1];
+		const float alpha = k[2] * dx + k[3] * dy;
+		const float beta = k[4] * dx + k[5] * dy;
+		const float gamma = 1.f - alpha - beta;
+		const float depth = std::min(std::min(alpha, beta), gamma);
+		const bool better = depth >= best;
+		best = better ? depth : best;
+		best_triangle = better ? triangle : best_triangle;
+		best_alpha = better ? alpha : best_alpha;
+		best_beta = better ? beta : best_beta;
+	}
+
+	if (best_triangle == NO_TRIANGLE) return false;
+	result.triangle = best_triangle;
+	result.barycentric = Barycentric(best_alpha, best_beta, 1.f - best_alpha - best_beta);
+	return true;
+}
+
+void TriangleGrid::locate(const float* x, const float* y, size_t count, PointLocation* results) const
+{
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			locate(x[i], y[i], results[i]);
+		}
+	}, 4096);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "primitives/Barycentric.h"
+#include "primitives/Triangle.h"
+
+/**
+ * \brief The triangle which contains a point.
+ */
+struct PointLocation
+{
+	/**
+	 * \brief The id of the triangle. ('TriangleGrid::NO_TRIANGLE' if no triangle contains the point)
+	 */
+	uint32_t triangle;
+
+	/**
+	 * \brief The barycentric coordinates of the point in the triangle.
+	 */
+	Barycentric barycentric;
+};
+
+/**
+ * \brief A uniform grid over 2D triangles which answers which triangle contains a point.
+ * Each cell stores the ids of the triangles whose bounding box overlaps it.
+ */
+class TriangleGrid
+{
+public:
+	/**
+	 * \brief The triangle id if no triangle contains the point.
+	 */
+	static const uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+	/**
+	 * \brief The constructor. Uses the x and y coordinates of the positions.
+	 * \param triangles The triangles.
+	 * \param cells_per_triangle The number of cells per triangle.
+	 */
+	explicit TriangleGrid(const std::vector<Triangle>& triangles, float cells_per_triangle = 1.f);
+
+	/**
+	 * \brief The constructor.
+	 * \param coordinates The 2D coordinates. (x0, y0, x1, y1, x2, y2 per triangle)
+	 * \param count The number of triangles.
+	 * \param cells_per_triangle The number of cells per triangle.
+	 */
+	TriangleGrid(const float* coordinates, size_t count, float cells_per_triangle = 1.f);
+
+	/**
+	 * \brief Finds the triangle which contains a point.
+	 * \param x The x coordinate.
+	 * \param y The y coordinate.
+	 * \param result The triangle and the barycentric coordinates.
+	 * \return Whether a triangle contains the point.
+	 */
+	bool locate(float x, float y, PointLocation& result) const;
+
+	/**
+	 * \brief Finds the triangles which contain many points on all threads.
+	 * \param x The x coordinates.
+	 * \param y The y coordinates.
+	 * \param count The number of points.
+	 * \param results The triangles and the barycentric coordinates.
+	 */
+	void locate(const float* x, const float* y, size_t count, PointLocation* results) const;
+
+private:
+	/**
+	 * \brief Builds the grid.
+	 * \param coordinates The 2D coordinates. (x0, y0, x1, y1, x2, y2 per triangle)
+	 * \param count The number of triangles.
+	 * \param cells_per_triangle The number of cells per triangle.
+	 */
+	void build(const float* coordinates, size_t count, float cells_per_triangle);
+
+	/**
+	 * \brief The minimum corner of the grid.
+	 */
+	float min_x, min_y;
+
+	/**
+	 * \brief The number of cells per unit.
+	 */
+	float scale_x, scale_y;
+
+	/**
+	 * \brief The number of cells per axis.
+	 */
+	int resolution_x, resolution_y;
+
+	/**
+	 * \brief The offset of each cell in 'cell_triangles'. (One more than cells)
+	 */
+	std::vector<uint32_t> cell_offsets;
+
+	/**
+	 * \brief The triangle ids of all cells.
+	 */
+	std::vector<uint32_t> cell_triangles;
+
+	/**
+	 * \brief The prepared barycentric coordinates of each triangle.
+	 * k[0], k[1] is the third vertex, alpha = k[2] * dx + k[3] * dy and beta = k[4] * dx + k[5] * dy
+	 * with dx, dy being the offset of the point to the third vertex.
+	 */
+	std::vector<float> coefficients;
+};
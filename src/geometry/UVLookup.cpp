@@ -0,0 +1,64 @@
+#include "UVLookup.h"
+
+#include "utilities/Parallel.h"
+
+UVLookup::UVLookup(const std::vector<Triangle>& triangles, float cells_per_triangle)
+	: triangles(triangles), grid(texture_coordinates(triangles).data(), triangles.size(), cells_per_triangle)
+{
+}
+
+bool UVLookup::locate(TexCoord uv, PointLocation& result) const
+{
+	return grid.locate(uv.u, uv.v, result);
+}
+
+void UVLookup::locate(const TexCoord* uvs, size_t count, PointLocation* results) const
+{
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			grid.locate(uvs[i].u, uvs[i].v, results[i]);
+		}
+	}, 4096);
+}
+
+size_t UVLookup::locate(const TexCoord* uvs, size_t count, Vertex* vertices) const
+{
+	std::vector<size_t> found(Utilities::thread_count(), 0);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int thread)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			PointLocation location;
+			if (!grid.locate(uvs[i].u, uvs[i].v, location))
+				continue;
+			vertices[i] = interpolate(location);
+			found[thread]++;
+		}
+	}, 4096);
+
+	size_t total = 0;
+	for (size_t thread_found : found)
+		total += thread_found;
+	return total;
+}
+
+Vertex UVLookup::interpolate(const PointLocation& location) const
+{
+	return triangles[location.triangle].interpolate(location.barycentric);
+}
+
+std::vector<float> UVLookup::texture_coordinates(const std::vector<Triangle>& triangles)
+{
+	std::vector<float> coordinates(6 * triangles.size());
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		for (int v = 0; v < 3; v++)
+		{
+			coordinates[6 * i + 2 * v + 0] = triangles[i].vertices[v].uv.u;
+			coordinates[6 * i + 2 * v + 1] = triangles[i].vertices[v].uv.v;
+		}
+	}
+	return coordinates;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "geometry/TriangleGrid.h"
+#include "primitives/TexCoord.h"
+#include "primitives/Triangle.h"
+#include "primitives/Vertex.h"
+
+/**
+ * \brief Maps texture coordinates back onto the surface, e.g. to project paint strokes or decals from a texture.
+ * A 'TriangleGrid' over the texture coordinates of the triangles finds the triangle whose texture coordinates
+ * contain a point. Where charts overlap, the triangle which contains the point deepest wins.
+ */
+class UVLookup
+{
+public:
+	/**
+	 * \brief The constructor. Builds the grid over the texture coordinates.
+	 * \param triangles The triangles. (e.g. of 'Mesh::get_triangles', they have to outlive the lookup)
+	 * \param cells_per_triangle The number of cells per triangle.
+	 */
+	explicit UVLookup(const std::vector<Triangle>& triangles, float cells_per_triangle = 1.f);
+
+	/**
+	 * \brief Finds the triangle whose texture coordinates contain a point.
+	 * \param uv The texture coordinates.
+	 * \param result The triangle and the barycentric coordinates.
+	 * \return Whether a triangle contains the point.
+	 */
+	bool locate(TexCoord uv, PointLocation& result) const;
+
+	/**
+	 * \brief Finds the triangles which contain many texture coordinates on all threads.
+	 * \param uvs The texture coordinates.
+	 * \param count The number of texture coordinates.
+	 * \param results The triangles and the barycentric coordinates.
+	 */
+	void locate(const TexCoord* uvs, size_t count, PointLocation* results) const;
+
+	/**
+	 * \brief Finds the surface points of many texture coordinates on all threads.
+	 * Texture coordinates which no triangle contains keep their vertex.
+	 * \param uvs The texture coordinates.
+	 * \param count The number of texture coordinates.
+	 * \param vertices The vertices at the surface points with all interpolated attributes.
+	 * \return The number of texture coordinates which a triangle contains.
+	 */
+	size_t locate(const TexCoord* uvs, size_t count, Vertex* vertices) const;
+
+	/**
+	 * \brief Returns the vertex at a location.
+	 * \param location The location. (found by 'locate')
+	 * \return The vertex with all interpolated attributes.
+	 */
+	Vertex interpolate(const PointLocation& location) const;
+
+private:
+	/**
+	 * \brief Returns the texture coordinates of the triangles for the grid.
+	 * \param triangles The triangles.
+	 * \return The coordinates. (u0, v0, u1, v1, u2, v2 per triangle)
+	 */
+	static std::vector<float> texture_coordinates(const std::vector<Triangle>& triangles);
+
+	/**
+	 * \brief The triangles.
+	 */
+	const std::vector<Triangle>& triangles;
+
+	/**
+	 * \brief The grid over the texture coordinates.
+	 */
+	TriangleGrid grid;
+};
@@ -0,0 +1,187 @@
+#include "VertexCurvature.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "utilities/Parallel.h"
+
+namespace
+{
+	/**
+	 * \brief The contribution of a face to one of its corner vertices.
+	 */
+	struct CornerContribution
+	{
+		/**
+		 * \brief The interior angle. (double, since the Gaussian curvature is the small defect of the angle sum)
+		 */
+		double angle;
+
+		/**
+		 * \brief The part of the mixed Voronoi area.
+		 */
+		float area;
+
+		/**
+		 * \brief The cotangent weighted edges, which sum up to the mean curvature normal times twice the area.
+		 */
+		float laplacian[3];
+
+		/**
+		 * \brief The angle weighted unit face normal.
+		 */
+		float normal[3];
+	};
+}
+
+VertexCurvature::VertexCurvature(const HalfEdgeMesh& mesh)
+{
+	const uint32_t face_count = mesh.face_count();
+	const uint32_t vertex_count = mesh.vertex_count();
+
+	// the contributions of each face to its corners, computed once per face
+	std::vector<CornerContribution> corners(mesh.half_edge_count());
+	Utilities::parallel_for(face_count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t face = begin; face < end; face++)
+		{
+			const uint32_t first = HalfEdgeMesh::half_edge(static_cast<uint32_t>(face));
+			double p[3][3];
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const Vec3f position = mesh.position(mesh.origin(first + corner));
+				p[corner][0] = position.x;
+				p[corner][1] = position.y;
+				p[corner][2] = position.z;
+			}
+
+			// the edge vectors from each corner to the next one, and the normal whose length is twice the area
+			double edges[3][3], squared_lengths[3];
+			for (int corner = 0; corner < 3; corner++)
+			{
+				for (int axis = 0; axis < 3; axis++)
+					edges[corner][axis] = p[(corner + 1) % 3][axis] - p[corner][axis];
+				squared_lengths[corner] = edges[corner][0] * edges[corner][0] + edges[corner][1] * edges[corner][1] + edges[corner][2] * edges[corner][2];
+			}
+			const double normal[3] = {
+				edges[0][1] * -edges[2][2] - edges[0][2] * -edges[2][1],
+				edges[0][2] * -edges[2][0] - edges[0][0] * -edges[2][2],
+				edges[0][0] * -edges[2][1] - edges[0][1] * -edges[2][0] };
+			const double double_area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (double_area == 0.0)
+			{
+				for (int corner = 0; corner < 3; corner++)
+					corners[first + corner] = CornerContribution();
+				continue;
+			}
+
+			// the cosine of the angle at a corner is the dot product of its outgoing edge and its reversed incoming edge
+			double dots[3], angles[3], cotangents[3];
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const double* out = edges[corner];
+				const double* in = edges[(corner + 2) % 3];
+				dots[corner] = -(out[0] * in[0] + out[1] * in[1] + out[2] * in[2]);
+				angles[corner] = std::atan2(double_area, dots[corner]);
+				cotangents[corner] = dots[corner] / double_area;
+			}
+			const bool obtuse = dots[0] < 0.0 || dots[1] < 0.0 || dots[2] < 0.0;
+
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const int next = (corner + 1) % 3, previous = (corner + 2) % 3;
+				CornerContribution& contribution = corners[first + corner];
+
+				// Voronoi area for non-obtuse faces, otherwise half of the area at the obtuse corner and a quarter elsewhere
+				if (!obtuse)
+					contribution.area = static_cast<float>((squared_lengths[previous] * cotangents[next] + squared_lengths[corner] * cotangents[previous]) / 8.0);
+				else
+					contribution.area = static_cast<float>(double_area * (dots[corner] < 0.0 ? 0.25 : 0.125));
+				contribution.angle = angles[corner];
+
+				// the edge to the next corner is opposite of the previous one and the other way round
+				for (int axis = 0; axis < 3; axis++)
+				{
+					contribution.laplacian[axis] = static_cast<float>(-cotangents[previous] * edges[corner][axis] + cotangents[next] * edges[previous][axis]);
+					contribution.normal[axis] = static_cast<float>(angles[corner] * normal[axis] / double_area);
+				}
+			}
+		}
+	}, 4096);
+
+	// the corners of each vertex in the order of the faces (counting sort)
+	const std::vector<uint32_t>& indices = mesh.get_indices();
+	std::vector<uint32_t> corner_begins(static_cast<size_t>(vertex_count) + 1, 0);
+	for (uint32_t vertex : indices)
+		corner_begins[vertex + 1]++;
+	for (uint32_t vertex = 0; vertex < vertex_count; vertex++)
+		corner_begins[vertex + 1] += corner_begins[vertex];
+	std::vector<uint32_t> vertex_corners(indices.size());
+	std::vector<uint32_t> cursors(corner_begins.begin(), corner_begins.end() - 1);
+	for (uint32_t corner = 0; corner < indices.size(); corner++)
+		vertex_corners[cursors[indices[corner]]++] = corner;
+
+	areas.resize(vertex_count);
+	mean_curvatures.resize(vertex_count);
+	gaussian_curvatures.resize(vertex_count);
+	for (int axis = 0; axis < 3; axis++)
+		normals[axis].resize(vertex_count);
+	Utilities::parallel_for(vertex_count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t vertex = begin; vertex < end; vertex++)
+		{
+			double area = 0.0, angle = 0.0, laplacian[3] = { 0.0, 0.0, 0.0 }, normal[3] = { 0.0, 0.0, 0.0 };
+			for (uint32_t i = corner_begins[vertex]; i < corner_begins[vertex + 1]; i++)
+			{
+				const CornerContribution& contribution = corners[vertex_corners[i]];
+				area += contribution.area;
+				angle += contribution.angle;
+				for (int axis = 0; axis < 3; axis++)
+				{
+					laplacian[axis] += contribution.laplacian[axis];
+					normal[axis] += contribution.normal[axis];
+				}
+			}
+
+			const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				normal[axis] = length > 0.0 ? normal[axis] / length : 0.0;
+				normals[axis][vertex] = static_cast<float>(normal[axis]);
+			}
+			areas[vertex] = static_cast<float>(area);
+			if (area == 0.0)
+			{
+				mean_curvatures[vertex] = gaussian_curvatures[vertex] = 0.f;
+				continue;
+			}
+
+			// the mean curvature normal is the laplacian over twice the area, and twice the mean curvature along the normal
+			const double full_angle = mesh.is_boundary_vertex(static_cast<uint32_t>(vertex)) ? 3.14159265358979323846 : 2.0 * 3.14159265358979323846;
+			mean_curvatures[vertex] = static_cast<float>((laplacian[0] * normal[0] + laplacian[1] * normal[1] + laplacian[2] * normal[2]) / (4.0 * area));
+			gaussian_curvatures[vertex] = static_cast<float>((full_angle - angle) / area);
+		}
+	}, 4096);
+}
+
+const std::vector<float>& VertexCurvature::get_areas() const
+{
+	return areas;
+}
+
+const std::vector<float>& VertexCurvature::get_mean_curvatures() const
+{
+	return mean_curvatures;
+}
+
+const std::vector<float>& VertexCurvature::get_gaussian_curvatures() const
+{
+	return gaussian_curvatures;
+}
+
+const std::vector<float>& VertexCurvature::get_normals(int axis) const
+{
+	if (axis < 0 || axis > 2)
+		throw std::invalid_argument("'VertexCurvature::get_normals' should only be called with axes 0-2.");
+	return normals[axis];
+}
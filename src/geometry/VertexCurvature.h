@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include "geometry/HalfEdgeMesh.h"
+
+/**
+ * \brief The mixed Voronoi areas, the discrete mean and Gaussian curvatures and the angle weighted normals of all
+ * vertices of a mesh. (Meyer et al., Discrete Differential-Geometry Operators for Triangulated 2-Manifolds)
+ * A single parallel pass over the faces computes the angles, cotangents and areas of each face once and writes the
+ * contributions to its corners, so no two threads write the same memory. A second parallel pass over the vertices
+ * gathers the contributions of their corners in a fixed order, so the results do not depend on the number of threads.
+ * The results are stored as structure of arrays, so analyses can stream only the quantities they need.
+ */
+class VertexCurvature
+{
+public:
+	/**
+	 * \brief The constructor. Computes all quantities on all threads.
+	 * \param mesh The mesh.
+	 */
+	explicit VertexCurvature(const HalfEdgeMesh& mesh);
+
+	/**
+	 * \brief Returns the mixed Voronoi areas, which sum up to the area of the mesh.
+	 * \return The areas. (one per vertex)
+	 */
+	const std::vector<float>& get_areas() const;
+
+	/**
+	 * \brief Returns the mean curvatures, positive where the surface bends away from its normals. (e.g. on a convex hull)
+	 * \return The mean curvatures. (one per vertex, 1 / radius on a sphere)
+	 */
+	const std::vector<float>& get_mean_curvatures() const;
+
+	/**
+	 * \brief Returns the Gaussian curvatures from the angle defects. (pi minus the angle sum on the boundary)
+	 * \return The Gaussian curvatures. (one per vertex, 1 / radius^2 on a sphere)
+	 */
+	const std::vector<float>& get_gaussian_curvatures() const;
+
+	/**
+	 * \brief Returns a component of the angle weighted vertex normals.
+	 * \param axis The axis. (0-2)
+	 * \return The components of the unit normals. (one per vertex, zero for isolated vertices)
+	 */
+	const std::vector<float>& get_normals(int axis) const;
+
+private:
+	/**
+	 * \brief The mixed Voronoi areas.
+	 */
+	std::vector<float> areas;
+
+	/**
+	 * \brief The mean curvatures.
+	 */
+	std::vector<float> mean_curvatures;
+
+	/**
+	 * \brief The Gaussian curvatures.
+	 */
+	std::vector<float> gaussian_curvatures;
+
+	/**
+	 * \brief The components of the normals.
+	 */
+	std::vector<float> normals[3];
+};
@@ -0,0 +1,165 @@
+#include "WalkQuery.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "math/Morton.h"
+#include "utilities/Parallel.h"
+
+/* Points on the edges are accepted up to this barycentric tolerance: */
+#define WALK_EPSILON 1e-6f
+
+/* The number of bits per axis of the Morton codes which order the batched queries: */
+#define WALK_MORTON_BITS 16
+
+const uint32_t WalkQuery::NO_TRIANGLE;
+
+WalkQuery::WalkQuery(const HalfEdgeMesh& mesh, uint32_t seed_count)
+	: mesh(mesh)
+{
+	const uint32_t faces = mesh.face_count();
+	if (faces == 0) return;
+	if (seed_count == 0)
+		seed_count = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<float>(faces))));
+	seed_count = std::min(seed_count, faces);
+
+	// evenly spread over the faces
+	seeds.resize(seed_count);
+	seed_centroids.resize(2 * static_cast<size_t>(seed_count));
+	for (uint32_t i = 0; i < seed_count; i++)
+	{
+		const uint32_t face = static_cast<uint32_t>(static_cast<uint64_t>(i) * faces / seed_count);
+		const uint32_t h = HalfEdgeMesh::half_edge(face);
+		const Vec3f a = mesh.position(mesh.origin(h)), b = mesh.position(mesh.origin(h + 1)), c = mesh.position(mesh.origin(h + 2));
+		seeds[i] = face;
+		seed_centroids[2 * i + 0] = (a.x + b.x + c.x) / 3.f;
+		seed_centroids[2 * i + 1] = (a.y + b.y + c.y) / 3.f;
+	}
+}
+
+bool WalkQuery::locate(float x, float y, PointLocation& result, uint32_t start) const
+{
+	result.triangle = NO_TRIANGLE;
+	if (mesh.empty()) return false;
+
+	if (start != NO_TRIANGLE && walk(x, y, start, result)) return true;
+
+	// jumps to the closest seed if there was no start or the walk got stuck at the boundary
+	const uint32_t seed = closest_seed(x, y);
+	return seed != start && walk(x, y, seed, result);
+}
+
+void WalkQuery::locate(const float* x, const float* y, size_t count, PointLocation* results) const
+{
+	if (count == 0) return;
+
+	// bounds of the points
+	float min_x = std::numeric_limits<float>::max(), min_y = std::numeric_limits<float>::max();
+	float max_x = -std::numeric_limits<float>::max(), max_y = -std::numeric_limits<float>::max();
+	for (size_t i = 0; i < count; i++)
+	{
+		min_x = std::min(min_x, x[i]);
+		max_x = std::max(max_x, x[i]);
+		min_y = std::min(min_y, y[i]);
+		max_y = std::max(max_y, y[i]);
+	}
+	const float cells = static_cast<float>((1 << WALK_MORTON_BITS) - 1);
+	const float scale_x = max_x > min_x ? cells / (max_x - min_x) : 0.f;
+	const float scale_y = max_y > min_y ? cells / (max_y - min_y) : 0.f;
+
+	// sorts the points along the Morton curve (code in the upper, index in the lower 32 bits)
+	std::vector<uint64_t> order(count);
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const uint64_t code = Morton::encode(
+				Morton::quantize(x[i], min_x, scale_x, WALK_MORTON_BITS),
+				Morton::quantize(y[i], min_y, scale_y, WALK_MORTON_BITS));
+			order[i] = code << 32 | i;
+		}
+	}, 4096);
+	std::sort(order.begin(), order.end());
+
+	// each walk starts at the triangle of the previous point
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		uint32_t previous = NO_TRIANGLE;
+		for (size_t i = begin; i < end; i++)
+		{
+			const size_t point = static_cast<size_t>(order[i] & 0xFFFFFFFFull);
+			if (locate(x[point], y[point], results[point], previous))
+				previous = results[point].triangle;
+		}
+	}, 1024);
+}
+
+bool WalkQuery::walk(float x, float y, uint32_t face, PointLocation& result) const
+{
+	uint32_t previous = NO_TRIANGLE;
+	for (uint32_t step = 0; step <= mesh.face_count(); step++)
+	{
+		const uint32_t h = HalfEdgeMesh::half_edge(face);
+		const Vec3f a = mesh.position(mesh.origin(h)), b = mesh.position(mesh.origin(h + 1)), c = mesh.position(mesh.origin(h + 2));
+
+		// barycentric coordinates scaled by the determinant, relative to the third vertex for precision
+		const float dx = x - c.x, dy = y - c.y;
+		const float det = (b.y - c.y) * (a.x - c.x) + (c.x - b.x) * (a.y - c.y);
+		float coordinates[3];
+		coordinates[0] = (b.y - c.y) * dx + (c.x - b.x) * dy;
+		coordinates[1] = (c.y - a.y) * dx + (a.x - c.x) * dy;
+		coordinates[2] = det - coordinates[0] - coordinates[1];
+
+		// the signs do not depend on the orientation of the triangle
+		const float sign = det < 0.f ? -1.f : 1.f;
+		const float tolerance = -WALK_EPSILON * std::abs(det);
+
+		// leaves over the edge opposite of the most negative coordinate
+		uint32_t exit = NO_TRIANGLE;
+		float most_negative = tolerance;
+		bool outside = false;
+		for (int i = 0; i < 3; i++)
+		{
+			const float coordinate = sign * coordinates[i];
+			const uint32_t twin = mesh.twin(h + (i + 1) % 3);
+			const bool crossable = twin != HalfEdgeMesh::INVALID && HalfEdgeMesh::face(twin) != previous;
+			outside |= coordinate < tolerance;
+			if (det == 0.f ? crossable && exit == NO_TRIANGLE : crossable && coordinate < most_negative)
+			{
+				most_negative = coordinate;
+				exit = twin;
+			}
+		}
+
+		if (det != 0.f && !outside)
+		{
+			result.triangle = face;
+			result.barycentric = Barycentric(coordinates[0] / det, coordinates[1] / det, coordinates[2] / det);
+			return true;
+		}
+
+		// the point lies behind the boundary
+		if (exit == NO_TRIANGLE) return false;
+		previous = face;
+		face = HalfEdgeMesh::face(exit);
+	}
+	return false;
+}
+
+uint32_t WalkQuery::closest_seed(float x, float y) const
+{
+	uint32_t best = 0;
+	float best_distance = std::numeric_limits<float>::infinity();
+	for (uint32_t i = 0; i < seeds.size(); i++)
+	{
+		const float dx = seed_centroids[2 * i] - x, dy = seed_centroids[2 * i + 1] - y;
+		const float distance = dx * dx + dy * dy;
+		if (distance < best_distance)
+		{
+			best_distance = distance;
+			best = i;
+		}
+	}
+	return seeds[best];
+}
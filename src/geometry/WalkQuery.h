@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "geometry/HalfEdgeMesh.h"
+#include "geometry/TriangleGrid.h"
+
+/**
+ * \brief Finds the triangle which contains a 2D point by walking across neighbouring triangles. (jump-and-walk)
+ * Uses the x and y coordinates of the vertices. Fast for spatially coherent queries, which can start at the last triangle.
+ */
+class WalkQuery
+{
+public:
+	/**
+	 * \brief The triangle id if no triangle contains the point or no start is given.
+	 */
+	static const uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+	/**
+	 * \brief The constructor. Samples the seed triangles.
+	 * \param mesh The mesh. (Has to outlive the query)
+	 * \param seed_count The number of seed triangles. (0 picks about the cube root of the number of triangles)
+	 */
+	explicit WalkQuery(const HalfEdgeMesh& mesh, uint32_t seed_count = 0);
+
+	/**
+	 * \brief Finds the triangle which contains a point.
+	 * The walk can stop at the boundary of non-convex meshes, then it is repeated from the closest seed.
+	 * \param x The x coordinate.
+	 * \param y The y coordinate.
+	 * \param result The triangle and the barycentric coordinates.
+	 * \param start The triangle to start at, e.g. of the previous query. ('NO_TRIANGLE' starts at the closest seed)
+	 * \return Whether a triangle contains the point.
+	 */
+	bool locate(float x, float y, PointLocation& result, uint32_t start = NO_TRIANGLE) const;
+
+	/**
+	 * \brief Finds the triangles which contain many points on all threads.
+	 * The points are walked in Morton order, so each walk starts close to its point.
+	 * \param x The x coordinates.
+	 * \param y The y coordinates.
+	 * \param count The number of points.
+	 * \param results The triangles and the barycentric coordinates.
+	 */
+	void locate(const float* x, const float* y, size_t count, PointLocation* results) const;
+
+private:
+	/**
+	 * \brief Walks from a triangle towards a point.
+	 * \param x The x coordinate.
+	 * \param y The y coordinate.
+	 * \param start The first triangle.
+	 * \param result The triangle and the barycentric coordinates.
+	 * \return Whether a triangle contains the point.
+	 */
+	bool walk(float x, float y, uint32_t start, PointLocation& result) const;
+
+	/**
+	 * \brief Returns the seed triangle with the closest centroid.
+	 * \param x The x coordinate.
+	 * \param y The y coordinate.
+	 * \return The triangle.
+	 */
+	uint32_t closest_seed(float x, float y) const;
+
+	/**
+	 * \brief The mesh.
+	 */
+	const HalfEdgeMesh& mesh;
+
+	/**
+	 * \brief The seed triangles.
+	 */
+	std::vector<uint32_t> seeds;
+
+	/**
+	 * \brief The centroids of the seed triangles. (x, y per seed)
+	 */
+	std::vector<float> seed_centroids;
+};
@@ -0,0 +1,145 @@
+#include "WindingNumberQuery.h"
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "utilities/Parallel.h"
+
+namespace
+{
+	/**
+	 * \brief Returns the solid angle of a triangle seen from the origin. (Van Oosterom and Strackee)
+	 */
+	inline float solid_angle(Vec3f a, Vec3f b, Vec3f c)
+	{
+		const float la = a.length(), lb = b.length(), lc = c.length();
+		const float determinant = a.dot(b.cross(c));
+		const float denominator = la * lb * lc + a.dot(b) * lc + b.dot(c) * la + c.dot(a) * lb;
+		return 2.f * std::atan2(determinant, denominator);
+	}
+}
+
+WindingNumberQuery::WindingNumberQuery(const BVH& bvh, float accuracy)
+	: bvh(bvh)
+{
+	const std::vector<BVHNode>& nodes = bvh.get_nodes();
+	dipoles.resize(nodes.size());
+	std::vector<float> areas(nodes.size()), radii(nodes.size());
+
+	// children always follow their parent, so the nodes are combined bottom up in reverse order
+	for (size_t i = nodes.size(); i-- > 0;)
+	{
+		const BVHNode& node = nodes[i];
+		Dipole& dipole = dipoles[i];
+		Vec3f center, normal;
+		float area = 0.f, radius = 0.f;
+		if (node.is_leaf())
+		{
+			for (uint32_t p = node.index; p < node.index + node.count; p++)
+			{
+				const Vec3f* v = bvh.get_vertices(p);
+				const Vec3f n = (v[1] - v[0]).cross(v[2] - v[0]) * 0.5f;
+				const float triangle_area = n.length();
+				center = center + (v[0] + v[1] + v[2]) * (triangle_area / 3.f);
+				normal = normal + n;
+				area += triangle_area;
+			}
+			center = area > 0.f ? center * (1.f / area) : Vec3f(node.bounds_min[0] + node.bounds_max[0],
+				node.bounds_min[1] + node.bounds_max[1], node.bounds_min[2] + node.bounds_max[2]) * 0.5f;
+			for (uint32_t p = node.index; p < node.index + node.count; p++)
+			{
+				const Vec3f* v = bvh.get_vertices(p);
+				for (int k = 0; k < 3; k++)
+					radius = std::max(radius, (v[k] - center).length());
+			}
+		}
+		else
+		{
+			const uint32_t left = node.index, right = node.index + 1;
+			area = areas[left] + areas[right];
+			center = area > 0.f ? (dipoles[left].center * areas[left] + dipoles[right].center * areas[right]) * (1.f / area)
+				: (dipoles[left].center + dipoles[right].center) * 0.5f;
+			normal = dipoles[left].normal + dipoles[right].normal;
+			radius = std::max((dipoles[left].center - center).length() + radii[left],
+				(dipoles[right].center - center).length() + radii[right]);
+
+			// the farthest corner of the bounding box is sometimes closer
+			float corner = 0.f;
+			for (int k = 0; k < 3; k++)
+			{
+				const float d = std::max(center[k] - node.bounds_min[k], node.bounds_max[k] - center[k]);
+				corner += d * d;
+			}
+			radius = std::min(radius, std::sqrt(corner));
+		}
+
+		areas[i] = area;
+		radii[i] = radius;
+		dipole.center = center;
+		dipole.normal = normal;
+		dipole.far_distance = accuracy * accuracy * radius * radius;
+	}
+}
+
+float WindingNumberQuery::winding_number(Vec4f point) const
+{
+	if (bvh.empty()) return 0.f;
+
+	const Vec3f q(point);
+	const std::vector<BVHNode>& nodes = bvh.get_nodes();
+	float sum = 0.f;
+
+	uint32_t stack[BVH_MAX_DEPTH + 1];
+	int size = 0;
+	stack[size++] = 0;
+	while (size > 0)
+	{
+		const uint32_t index = stack[--size];
+		const Dipole& dipole = dipoles[index];
+		const Vec3f r = dipole.center - q;
+		const float distance = r.squaredLength();
+
+		// far field: the solid angle of the dipole
+		if (distance > dipole.far_distance)
+		{
+			sum += dipole.normal.dot(r) / (distance * std::sqrt(distance));
+			continue;
+		}
+
+		// near field: the exact solid angles
+		const BVHNode& node = nodes[index];
+		if (node.is_leaf())
+		{
+			for (uint32_t p = node.index; p < node.index + node.count; p++)
+			{
+				const Vec3f* v = bvh.get_vertices(p);
+				sum += solid_angle(v[0] - q, v[1] - q, v[2] - q);
+			}
+			continue;
+		}
+		stack[size++] = node.index;
+		stack[size++] = node.index + 1;
+	}
+	return sum / (4.f * static_cast<float>(M_PI));
+}
+
+void WindingNumberQuery::winding_numbers(const Vec4f* points, size_t count, float* results) const
+{
+	Utilities::parallel_for(count, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			results[i] = winding_number(points[i]);
+		}
+	}, 256);
+}
+
+bool WindingNumberQuery::is_inside(Vec4f point) const
+{
+	return winding_number(point) > 0.5f;
+}
+
+float WindingNumberQuery::triangle_winding_number(Vec3f a, Vec3f b, Vec3f c)
+{
+	return solid_angle(a, b, c) / (4.f * static_cast<float>(M_PI));
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "geometry/BVH.h"
+
+/* The default ratio of distance to cluster radius above which a cluster is approximated by its dipole: */
+#define WINDING_NUMBER_ACCURACY 2.f
+
+/**
+ * \brief Computes generalized winding numbers of points with respect to the triangles of a bounding volume hierarchy.
+ * The winding number is 1 inside and 0 outside of closed meshes and degrades gracefully for holes, overlaps and
+ * open meshes, where ray parity tests fail. Far clusters of triangles are approximated by a dipole (their
+ * area-weighted normal at their area-weighted center), near triangles are evaluated exactly. (Barill et al. 2018)
+ */
+class WindingNumberQuery
+{
+public:
+	/**
+	 * \brief The constructor. Precomputes the dipole of every node.
+	 * \param bvh The bounding volume hierarchy. (Has to outlive the query)
+	 * \param accuracy The ratio of distance to cluster radius above which a cluster is approximated.
+	 * (Larger is more accurate and slower)
+	 */
+	explicit WindingNumberQuery(const BVH& bvh, float accuracy = WINDING_NUMBER_ACCURACY);
+
+	/**
+	 * \brief Computes the winding number of a point.
+	 * \param point The point.
+	 * \return The winding number.
+	 */
+	float winding_number(Vec4f point) const;
+
+	/**
+	 * \brief Computes the winding numbers of many points on all threads.
+	 * \param points The points.
+	 * \param count The number of points.
+	 * \param results The winding numbers.
+	 */
+	void winding_numbers(const Vec4f* points, size_t count, float* results) const;
+
+	/**
+	 * \brief Whether a point lies inside the mesh. (winding number above 0.5)
+	 * \param point The point.
+	 * \return Is the point inside.
+	 */
+	bool is_inside(Vec4f point) const;
+
+	/**
+	 * \brief Returns the solid angle of a triangle seen from the origin, divided by 4 pi.
+	 * Positive if the counterclockwise side faces away from the origin.
+	 * \param a The first vertex, relative to the origin.
+	 * \param b The second vertex, relative to the origin.
+	 * \param c The third vertex, relative to the origin.
+	 * \return The winding number of the triangle.
+	 */
+	static float triangle_winding_number(Vec3f a, Vec3f b, Vec3f c);
+
+private:
+	/**
+	 * \brief The dipole of a node.
+	 */
+	struct Dipole
+	{
+		/**
+		 * \brief The area-weighted center of the triangles.
+		 */
+		Vec3f center;
+
+		/**
+		 * \brief The squared distance from the center above which the dipole is used.
+		 */
+		float far_distance;
+
+		/**
+		 * \brief The sum of the area-weighted normals of the triangles.
+		 */
+		Vec3f normal;
+	};
+
+	/**
+	 * \brief The bounding volume hierarchy.
+	 */
+	const BVH& bvh;
+
+	/**
+	 * \brief The dipole of each node of the hierarchy.
+	 */
+	std::vector<Dipole> dipoles;
+};
@@ -0,0 +1,241 @@
+#include "ConjugateGradient.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "utilities/Parallel.h"
+
+/* The number of elements per chunk of the vector operations: (fixed, so the sums do not depend on the threads) */
+#define CONJUGATE_GRADIENT_GRAIN 8192
+
+/* The first relative diagonal shift when IC(0) breaks down, doubled until the factorization succeeds: */
+#define CONJUGATE_GRADIENT_INITIAL_SHIFT 1e-3
+
+namespace
+{
+	/**
+	 * \brief Returns the dot product of two vectors on all threads.
+	 * \param a The first vector.
+	 * \param b The second vector.
+	 * \return The dot product.
+	 */
+	double dot(const std::vector<double>& a, const std::vector<double>& b)
+	{
+		std::vector<double> chunk_sums((a.size() + CONJUGATE_GRADIENT_GRAIN - 1) / CONJUGATE_GRADIENT_GRAIN, 0.0);
+		Utilities::parallel_for(a.size(), [&](size_t begin, size_t end, unsigned int)
+		{
+			// a single thread gets the whole range, so the chunks are summed separately
+			for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += CONJUGATE_GRADIENT_GRAIN)
+			{
+				const size_t chunk_end = std::min(end, chunk_begin + CONJUGATE_GRADIENT_GRAIN);
+				double sum = 0.0;
+				for (size_t i = chunk_begin; i < chunk_end; i++)
+					sum += a[i] * b[i];
+				chunk_sums[chunk_begin / CONJUGATE_GRADIENT_GRAIN] = sum;
+			}
+		}, CONJUGATE_GRADIENT_GRAIN);
+
+		double sum = 0.0;
+		for (double chunk_sum : chunk_sums)
+			sum += chunk_sum;
+		return sum;
+	}
+}
+
+ConjugateGradient::ConjugateGradient(SparseMatrix matrix, bool incomplete_cholesky)
+	: matrix(std::move(matrix))
+{
+	if (this->matrix.row_count() != this->matrix.column_count())
+		throw std::invalid_argument("'ConjugateGradient' should only be called with a square matrix.");
+
+	if (incomplete_cholesky)
+	{
+		factorize();
+		return;
+	}
+	inverse_diagonal = this->matrix.diagonal();
+	for (double& value : inverse_diagonal)
+		value = value != 0.0 ? 1.0 / value : 0.0;
+}
+
+const SparseMatrix& ConjugateGradient::get_matrix() const
+{
+	return matrix;
+}
+
+uint32_t ConjugateGradient::solve(const std::vector<double>& b, std::vector<double>& x, double tolerance, uint32_t max_iterations) const
+{
+	const size_t n = matrix.row_count();
+	if (b.size() != n)
+		throw std::invalid_argument("'ConjugateGradient::solve' should only be called with one value per row.");
+	if (x.size() != n)
+		x.assign(n, 0.0);
+	if (max_iterations == 0)
+		max_iterations = static_cast<uint32_t>(n);
+
+	const double b_norm = std::sqrt(dot(b, b));
+	if (b_norm == 0.0)
+	{
+		x.assign(n, 0.0);
+		return 0;
+	}
+
+	std::vector<double> r(n), z(n), p(n), q(n);
+	matrix.multiply(x.data(), q.data());
+	Utilities::parallel_for(n, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t i = begin; i < end; i++)
+			r[i] = b[i] - q[i];
+	}, CONJUGATE_GRADIENT_GRAIN);
+	precondition(r, z);
+	p = z;
+	double rz = dot(r, z);
+
+	for (uint32_t iteration = 0; iteration < max_iterations; iteration++)
+	{
+		if (std::sqrt(dot(r, r)) <= tolerance * b_norm)
+			return iteration;
+
+		matrix.multiply(p.data(), q.data());
+		const double pq = dot(p, q);
+		if (pq <= 0.0)
+			return iteration;
+		const double alpha = rz / pq;
+		Utilities::parallel_for(n, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				x[i] += alpha * p[i];
+				r[i] -= alpha * q[i];
+			}
+		}, CONJUGATE_GRADIENT_GRAIN);
+
+		precondition(r, z);
+		const double next_rz = dot(r, z);
+		const double beta = next_rz / rz;
+		rz = next_rz;
+		Utilities::parallel_for(n, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+				p[i] = z[i] + beta * p[i];
+		}, CONJUGATE_GRADIENT_GRAIN);
+	}
+	return max_iterations;
+}
+
+void ConjugateGradient::precondition(const std::vector<double>& r, std::vector<double>& z) const
+{
+	const size_t n = r.size();
+	if (!inverse_diagonal.empty())
+	{
+		Utilities::parallel_for(n, [&](size_t begin, size_t end, unsigned int)
+		{
+			for (size_t i = begin; i < end; i++)
+				z[i] = inverse_diagonal[i] * r[i];
+		}, CONJUGATE_GRADIENT_GRAIN);
+		return;
+	}
+
+	// forward substitution with the rows of L, then backward substitution with the rows of L^T
+	for (size_t i = 0; i < n; i++)
+	{
+		double sum = r[i];
+		for (uint32_t k = factor_begins[i]; k < factor_begins[i + 1]; k++)
+			sum -= factor_values[k] * z[factor_columns[k]];
+		z[i] = sum * inverse_pivots[i];
+	}
+	for (size_t i = n; i-- > 0;)
+	{
+		double sum = z[i];
+		for (uint32_t k = transpose_begins[i]; k < transpose_begins[i + 1]; k++)
+			sum -= transpose_values[k] * z[transpose_rows[k]];
+		z[i] = sum * inverse_pivots[i];
+	}
+}
+
+void ConjugateGradient::factorize()
+{
+	// the strictly lower triangle of the matrix and its diagonal, which has to be stored
+	const uint32_t n = matrix.row_count();
+	const std::vector<uint32_t>& row_begins = matrix.get_row_begins();
+	const std::vector<uint32_t>& columns = matrix.get_columns();
+	const std::vector<double>& values = matrix.get_values();
+	factor_begins.assign(static_cast<size_t>(n) + 1, 0);
+	factor_columns.clear();
+	std::vector<double> lower, diagonal(n);
+	for (uint32_t row = 0; row < n; row++)
+	{
+		uint32_t i = row_begins[row];
+		for (; i < row_begins[row + 1] && columns[i] < row; i++)
+		{
+			factor_columns.push_back(columns[i]);
+			lower.push_back(values[i]);
+		}
+		if (i == row_begins[row + 1] || columns[i] != row)
+			throw std::invalid_argument("'ConjugateGradient' should only be called with matrices whose diagonal entries are stored.");
+		diagonal[row] = values[i];
+		factor_begins[row + 1] = static_cast<uint32_t>(factor_columns.size());
+	}
+
+	inverse_pivots.resize(n);
+	for (double shift = 0.0;; shift = shift == 0.0 ? CONJUGATE_GRADIENT_INITIAL_SHIFT : 2.0 * shift)
+	{
+		factor_values = lower;
+		bool broken = false;
+		for (uint32_t row = 0; row < n && !broken; row++)
+		{
+			const uint32_t begin = factor_begins[row], end = factor_begins[row + 1];
+			double pivot = diagonal[row] * (1.0 + shift);
+			for (uint32_t k = begin; k < end; k++)
+			{
+				// L_ij = (A_ij - sum of L_im * L_jm over m < j) / L_jj, merging the sorted rows i and j
+				const uint32_t column = factor_columns[k];
+				double sum = factor_values[k];
+				uint32_t a = begin, b = factor_begins[column];
+				while (a < k && b < factor_begins[column + 1])
+				{
+					if (factor_columns[a] < factor_columns[b])
+						a++;
+					else if (factor_columns[a] > factor_columns[b])
+						b++;
+					else
+						sum -= factor_values[a++] * factor_values[b++];
+				}
+				factor_values[k] = sum * inverse_pivots[column];
+				pivot -= factor_values[k] * factor_values[k];
+			}
+
+			// rows without entries (e.g. of isolated vertices) keep the identity
+			if (diagonal[row] == 0.0)
+				pivot = 1.0;
+			else if (!(pivot > 0.0))
+				broken = true;
+			inverse_pivots[row] = 1.0 / std::sqrt(pivot);
+		}
+		if (!broken)
+			break;
+		if (shift > 1.0)
+			throw std::invalid_argument("'ConjugateGradient' should only be called with positive definite matrices.");
+	}
+
+	// the rows of L^T, so the backward substitution gathers like the forward one
+	transpose_begins.assign(static_cast<size_t>(n) + 1, 0);
+	for (uint32_t column : factor_columns)
+		transpose_begins[column + 1]++;
+	for (uint32_t row = 0; row < n; row++)
+		transpose_begins[row + 1] += transpose_begins[row];
+	transpose_rows.resize(factor_columns.size());
+	transpose_values.resize(factor_columns.size());
+	std::vector<uint32_t> cursors(transpose_begins.begin(), transpose_begins.end() - 1);
+	for (uint32_t row = 0; row < n; row++)
+	{
+		for (uint32_t k = factor_begins[row]; k < factor_begins[row + 1]; k++)
+		{
+			const uint32_t slot = cursors[factor_columns[k]]++;
+			transpose_rows[slot] = row;
+			transpose_values[slot] = factor_values[k];
+		}
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/SparseMatrix.h"
+
+/* The relative residual at which the conjugate gradient stops by default: */
+#define CONJUGATE_GRADIENT_TOLERANCE 1e-8
+
+/**
+ * \brief Solves sparse symmetric positive definite systems with the preconditioned conjugate gradient method.
+ * The preconditioner is computed once in the constructor and reused for every solve, so many right hand sides
+ * (e.g. one per smoothing step or per channel) only pay for the iterations. The incomplete Cholesky factorization
+ * without fill-in (IC(0)) needs far fewer iterations than the Jacobi preconditioner, but its triangular solves
+ * run on one thread. Matrices which are no M-matrices (e.g. cotangent Laplacians with obtuse angles) can break
+ * IC(0) down, then the diagonal is scaled up until the factorization succeeds. (Manteuffel)
+ */
+class ConjugateGradient
+{
+public:
+	/**
+	 * \brief The constructor. Computes the preconditioner.
+	 * \param matrix The symmetric positive definite matrix. (all diagonal entries have to be stored)
+	 * \param incomplete_cholesky Whether to use IC(0) instead of the Jacobi preconditioner.
+	 */
+	explicit ConjugateGradient(SparseMatrix matrix, bool incomplete_cholesky = true);
+
+	/**
+	 * \brief Returns the matrix.
+	 * \return The matrix.
+	 */
+	const SparseMatrix& get_matrix() const;
+
+	/**
+	 * \brief Solves the system matrix * x = b on all threads.
+	 * \param b The right hand side.
+	 * \param x The initial guess, which returns the solution. (zero if it has the wrong size)
+	 * \param tolerance The residual relative to the right hand side at which the iteration stops.
+	 * \param max_iterations The maximum number of iterations. (0 for the number of rows)
+	 * \return The number of iterations.
+	 */
+	uint32_t solve(const std::vector<double>& b, std::vector<double>& x,
+		double tolerance = CONJUGATE_GRADIENT_TOLERANCE, uint32_t max_iterations = 0) const;
+
+private:
+	/**
+	 * \brief Applies the preconditioner. (z = M^-1 r)
+	 * \param r The residual.
+	 * \param z The preconditioned residual.
+	 */
+	void precondition(const std::vector<double>& r, std::vector<double>& z) const;
+
+	/**
+	 * \brief Computes the incomplete Cholesky factor with the pattern of the lower triangle of the matrix.
+	 * Also stores its transpose, so both substitutions read rows.
+	 */
+	void factorize();
+
+	/**
+	 * \brief The matrix.
+	 */
+	SparseMatrix matrix;
+
+	/**
+	 * \brief The inverse diagonal for the Jacobi preconditioner. (empty for IC(0))
+	 */
+	std::vector<double> inverse_diagonal;
+
+	/**
+	 * \brief The offset of each row of the strictly lower triangle of the incomplete Cholesky factor L.
+	 */
+	std::vector<uint32_t> factor_begins;
+
+	/**
+	 * \brief The columns of the strictly lower triangle of L.
+	 */
+	std::vector<uint32_t> factor_columns;
+
+	/**
+	 * \brief The values of the strictly lower triangle of L.
+	 */
+	std::vector<double> factor_values;
+
+	/**
+	 * \brief The inverse diagonal of L, so the substitutions do not divide.
+	 */
+	std::vector<double> inverse_pivots;
+
+	/**
+	 * \brief The offset of each row of the strictly upper triangle of L^T.
+	 */
+	std::vector<uint32_t> transpose_begins;
+
+	/**
+	 * \brief The columns of the strictly upper triangle of L^T.
+	 */
+	std::vector<uint32_t> transpose_rows;
+
+	/**
+	 * \brief The values of the strictly upper triangle of L^T.
+	 */
+	std::vector<double> transpose_values;
+};
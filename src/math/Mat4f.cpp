@@ -4,6 +4,7 @@
 #define _USE_MATH_DEFINES
 #include <iostream>
 #include <math.h>
+#include <cmath>
 
 Mat4f::Mat4f(Vec4f v1, Vec4f v2, Vec4f v3, Vec4f v4) : data{v1, v2, v3, v4}
 {
@@ -225,37 +226,40 @@ Mat4f Mat4f::translation(float x, float y, float z)
 
 Mat4f Mat4f::rotationX(float angle)
 {
+	const float s = std::sin(angle), c = std::cos(angle);
 	Mat4f result;
-	result[1][1] = std::cosf(angle);
-	result[1][2] = std::sinf(angle);
-	result[2][1] = -std::sinf(angle);
-	result[2][2] = std::cosf(angle);
+	result[1][1] = c;
+	result[1][2] = s;
+	result[2][1] = -s;
+	result[2][2] = c;
 	return result;
 }
 
 Mat4f Mat4f::rotationY(float angle)
 {
+	const float s = std::sin(angle), c = std::cos(angle);
 	Mat4f result;
-	result[0][0] = std::cosf(angle);
-	result[2][0] = std::sinf(angle);
-	result[0][2] = -std::sinf(angle);
-	result[2][2] = std::cosf(angle);
+	result[0][0] = c;
+	result[2][0] = s;
+	result[0][2] = -s;
+	result[2][2] = c;
 	return result;
 }
 
 Mat4f Mat4f::rotationZ(float angle)
 {
+	const float s = std::sin(angle), c = std::cos(angle);
 	Mat4f result;
-	result[0][0] = std::cosf(angle);
-	result[1][0] = -std::sinf(angle);
-	result[0][1] = std::sinf(angle);
-	result[1][1] = std::cosf(angle);
+	result[0][0] = c;
+	result[1][0] = -s;
+	result[0][1] = s;
+	result[1][1] = c;
 	return result;
 }
 
 Mat4f Mat4f::rotation(float angleX, float angleY, float angleZ)
 {
-	return rotationX(angleX) * rotationY(angleY) * rotationZ(angleZ);
+	return transformation(Vec4f(0, 0, 0, 0), angleX, angleY, angleZ, Vec4f(1, 1, 1, 0));
 }
 
 Mat4f Mat4f::scale(float scale)
@@ -272,6 +276,34 @@ Mat4f Mat4f::scale(float xScale, float yScale, float zScale)
 	return result;
 }
 
+Mat4f Mat4f::transformation(Vec4f translation, float angleX, float angleY, float angleZ, Vec4f scale)
+{
+	// expanded product rotationX * rotationY * rotationZ, one sin/cos per angle
+	const float sx = std::sin(angleX), cx = std::cos(angleX);
+	const float sy = std::sin(angleY), cy = std::cos(angleY);
+	const float sz = std::sin(angleZ), cz = std::cos(angleZ);
+	return Mat4f(
+		Vec4f(cy * cz, cx * sz + sx * sy * cz, sx * sz - cx * sy * cz, 0) * scale.x,
+		Vec4f(-cy * sz, cx * cz - sx * sy * sz, sx * cz + cx * sy * sz, 0) * scale.y,
+		Vec4f(sy, -sx * cy, cx * cy, 0) * scale.z,
+		Vec4f(translation.x, translation.y, translation.z, 1)
+	);
+}
+
+Mat4f Mat4f::transformation(Vec4f translation, Quaternion rotation, Vec4f scale)
+{
+	const float x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+	const float xx = x * x, yy = y * y, zz = z * z;
+	const float xy = x * y, xz = x * z, yz = y * z;
+	const float wx = w * x, wy = w * y, wz = w * z;
+	return Mat4f(
+		Vec4f(1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0) * scale.x,
+		Vec4f(2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0) * scale.y,
+		Vec4f(2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0) * scale.z,
+		Vec4f(translation.x, translation.y, translation.z, 1)
+	);
+}
+
 Mat4f Mat4f::perspectiveTransformation(float aspectRatio, float fov, float near, float far)
 {
 	fov *= static_cast<float>(M_PI);
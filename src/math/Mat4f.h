@@ -1,5 +1,6 @@
 #pragma once
 #include "Vec4f.h"
+#include "Quaternion.h"
 
 /**
  * \brief A 4x4 matrix in column-major order.
@@ -175,6 +176,27 @@ public:
 	 */
 	static Mat4f scale(float xScale, float yScale, float zScale = 1.f);
 
+	/**
+	 * \brief Returns a matrix which performs a scaling, a rotation and then a translation.
+	 * Builds the result directly instead of multiplying the single matrices.
+	 * \param translation The translation.
+	 * \param angleX The rotation around the x-axis.
+	 * \param angleY The rotation around the y-axis.
+	 * \param angleZ The rotation around the z-axis.
+	 * \param scale The scaling of each axis.
+	 * \return The transformation matrix.
+	 */
+	static Mat4f transformation(Vec4f translation, float angleX, float angleY, float angleZ, Vec4f scale = { 1, 1, 1, 0 });
+
+	/**
+	 * \brief Returns a matrix which performs a scaling, a rotation and then a translation.
+	 * \param translation The translation.
+	 * \param rotation The unit quaternion of the rotation.
+	 * \param scale The scaling of each axis.
+	 * \return The transformation matrix.
+	 */
+	static Mat4f transformation(Vec4f translation, Quaternion rotation, Vec4f scale = { 1, 1, 1, 0 });
+
 	/* */
 	/**
 	 * \brief Returns a matrix which performs the perpective transformation.
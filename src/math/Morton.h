@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * \brief Morton codes (z-order curve), which keep points close in space close in the order.
+ */
+namespace Morton
+{
+	/**
+	 * \brief Inserts a zero bit after each of the lower 32 bits.
+	 * \param v The value.
+	 * \return The spread bits.
+	 */
+	inline uint64_t spread_2d(uint64_t v)
+	{
+		v &= 0xFFFFFFFFull;
+		v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+		v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+		v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+		v = (v | (v << 2)) & 0x3333333333333333ull;
+		v = (v | (v << 1)) & 0x5555555555555555ull;
+		return v;
+	}
+
+	/**
+	 * \brief Inserts two zero bits after each of the lower 21 bits.
+	 * \param v The value.
+	 * \return The spread bits.
+	 */
+	inline uint64_t spread_3d(uint64_t v)
+	{
+		v &= 0x1FFFFFull;
+		v = (v | (v << 32)) & 0x001F00000000FFFFull;
+		v = (v | (v << 16)) & 0x001F0000FF0000FFull;
+		v = (v | (v << 8)) & 0x100F00F00F00F00Full;
+		v = (v | (v << 4)) & 0x10C30C30C30C30C3ull;
+		v = (v | (v << 2)) & 0x1249249249249249ull;
+		return v;
+	}
+
+	/**
+	 * \brief Returns the 2D Morton code of two coordinates.
+	 * \param x The first coordinate.
+	 * \param y The second coordinate.
+	 * \return The code.
+	 */
+	inline uint64_t encode(uint32_t x, uint32_t y)
+	{
+		return spread_2d(x) | spread_2d(y) << 1;
+	}
+
+	/**
+	 * \brief Returns the 3D Morton code of three coordinates.
+	 * \param x The first coordinate. (21 bits)
+	 * \param y The second coordinate. (21 bits)
+	 * \param z The third coordinate. (21 bits)
+	 * \return The code.
+	 */
+	inline uint64_t encode(uint32_t x, uint32_t y, uint32_t z)
+	{
+		return spread_3d(x) | spread_3d(y) << 1 | spread_3d(z) << 2;
+	}
+
+	/**
+	 * \brief Maps a coordinate into a grid of 2^bits cells.
+	 * \param value The coordinate.
+	 * \param min The minimum coordinate.
+	 * \param scale The number of cells per unit.
+	 * \param bits The number of bits per coordinate. (at most 24, so the cells are exact floats)
+	 * \return The cell. (clamped into the grid)
+	 */
+	inline uint32_t quantize(float value, float min, float scale, int bits)
+	{
+		const float max = static_cast<float>((1ull << bits) - 1);
+		const float cell = (value - min) * scale;
+		return static_cast<uint32_t>(cell > 0.f ? (cell < max ? cell : max) : 0.f);
+	}
+}
@@ -0,0 +1,264 @@
+#include "Predicates.h"
+
+#include <algorithm>
+
+/* The maximum number of components of the expansions of the exact in-circle test: */
+#define PREDICATES_MAX_EXPANSION 1536
+
+namespace
+{
+	/**
+	 * \brief Splits a double into two halves with 26 bits each. (Dekker)
+	 */
+	inline void split(double a, double& high, double& low)
+	{
+		const double c = 134217729.0 * a;
+		const double big = c - a;
+		high = c - big;
+		low = a - high;
+	}
+
+	/**
+	 * \brief Computes a + b = x + y exactly, if |a| >= |b|.
+	 */
+	inline void fast_two_sum(double a, double b, double& x, double& y)
+	{
+		x = a + b;
+		y = b - (x - a);
+	}
+
+	/**
+	 * \brief Computes a + b = x + y exactly.
+	 */
+	inline void two_sum(double a, double b, double& x, double& y)
+	{
+		x = a + b;
+		const double b_virtual = x - a;
+		const double a_virtual = x - b_virtual;
+		y = (a - a_virtual) + (b - b_virtual);
+	}
+
+	/**
+	 * \brief Computes a - b = x + y exactly.
+	 */
+	inline void two_diff(double a, double b, double& x, double& y)
+	{
+		x = a - b;
+		const double b_virtual = a - x;
+		const double a_virtual = x + b_virtual;
+		y = (a - a_virtual) + (b_virtual - b);
+	}
+
+	/**
+	 * \brief Computes a * b = x + y exactly.
+	 */
+	inline void two_product(double a, double b, double& x, double& y)
+	{
+		x = a * b;
+		double a_high, a_low, b_high, b_low;
+		split(a, a_high, a_low);
+		split(b, b_high, b_low);
+		const double error1 = x - a_high * b_high;
+		const double error2 = error1 - a_low * b_high;
+		const double error3 = error2 - a_high * b_low;
+		y = a_low * b_low - error3;
+	}
+
+	/**
+	 * \brief Stores the exact difference a - b as an expansion.
+	 * \return The number of components.
+	 */
+	inline int difference(double a, double b, double* h)
+	{
+		double x, y;
+		two_diff(a, b, x, y);
+		if (y == 0.0)
+		{
+			h[0] = x;
+			return 1;
+		}
+		h[0] = y;
+		h[1] = x;
+		return 2;
+	}
+
+	/**
+	 * \brief Sums two expansions without zero components. (components in increasing magnitude)
+	 * \return The number of components of h.
+	 */
+	int sum(int e_length, const double* e, int f_length, const double* f, double* h)
+	{
+		int e_index = 0, f_index = 0, h_index = 0;
+		double e_now = e[0], f_now = f[0];
+		double q, q_new, hh;
+		if ((f_now > e_now) == (f_now > -e_now))
+		{
+			q = e_now;
+			e_now = ++e_index < e_length ? e[e_index] : 0.0;
+		}
+		else
+		{
+			q = f_now;
+			f_now = ++f_index < f_length ? f[f_index] : 0.0;
+		}
+		while (e_index < e_length && f_index < f_length)
+		{
+			if ((f_now > e_now) == (f_now > -e_now))
+			{
+				two_sum(q, e_now, q_new, hh);
+				e_now = ++e_index < e_length ? e[e_index] : 0.0;
+			}
+			else
+			{
+				two_sum(q, f_now, q_new, hh);
+				f_now = ++f_index < f_length ? f[f_index] : 0.0;
+			}
+			q = q_new;
+			if (hh != 0.0) h[h_index++] = hh;
+		}
+		while (e_index < e_length)
+		{
+			two_sum(q, e_now, q_new, hh);
+			e_now = ++e_index < e_length ? e[e_index] : 0.0;
+			q = q_new;
+			if (hh != 0.0) h[h_index++] = hh;
+		}
+		while (f_index < f_length)
+		{
+			two_sum(q, f_now, q_new, hh);
+			f_now = ++f_index < f_length ? f[f_index] : 0.0;
+			q = q_new;
+			if (hh != 0.0) h[h_index++] = hh;
+		}
+		if (q != 0.0 || h_index == 0) h[h_index++] = q;
+		return h_index;
+	}
+
+	/**
+	 * \brief Multiplies an expansion with a double without zero components.
+	 * \return The number of components of h.
+	 */
+	int scale(int e_length, const double* e, double b, double* h)
+	{
+		int h_index = 0;
+		double q, hh;
+		two_product(e[0], b, q, hh);
+		if (hh != 0.0) h[h_index++] = hh;
+		for (int i = 1; i < e_length; i++)
+		{
+			double product1, product0, s;
+			two_product(e[i], b, product1, product0);
+			two_sum(q, product0, s, hh);
+			if (hh != 0.0) h[h_index++] = hh;
+			fast_two_sum(product1, s, q, hh);
+			if (hh != 0.0) h[h_index++] = hh;
+		}
+		if (q != 0.0 || h_index == 0) h[h_index++] = q;
+		return h_index;
+	}
+
+	/**
+	 * \brief Multiplies two expansions. (e has at most 32 components, h needs 2 * e_length * f_length components)
+	 * \return The number of components of h.
+	 */
+	int multiply(int e_length, const double* e, int f_length, const double* f, double* h)
+	{
+		double scaled[64];
+		double buffer[PREDICATES_MAX_EXPANSION];
+		int h_length = scale(e_length, e, f[0], h);
+		for (int i = 1; i < f_length; i++)
+		{
+			const int scaled_length = scale(e_length, e, f[i], scaled);
+			const int buffer_length = sum(h_length, h, scaled_length, scaled, buffer);
+			std::copy(buffer, buffer + buffer_length, h);
+			h_length = buffer_length;
+		}
+		return h_length;
+	}
+
+	/**
+	 * \brief Negates an expansion.
+	 */
+	void negate(int e_length, double* e)
+	{
+		for (int i = 0; i < e_length; i++)
+			e[i] = -e[i];
+	}
+
+	/**
+	 * \brief Returns the sign of an expansion. (the sign of its largest component)
+	 */
+	double sign(int e_length, const double* e)
+	{
+		const double largest = e[e_length - 1];
+		return largest > 0.0 ? 1.0 : (largest < 0.0 ? -1.0 : 0.0);
+	}
+
+	/**
+	 * \brief Computes the exact 2x2 determinant a * d - b * c of expansions.
+	 * \return The number of components of h.
+	 */
+	int determinant(int a_length, const double* a, int b_length, const double* b,
+		int c_length, const double* c, int d_length, const double* d, double* h)
+	{
+		double ad[32], bc[32];
+		const int ad_length = multiply(a_length, a, d_length, d, ad);
+		const int bc_length = multiply(b_length, b, c_length, c, bc);
+		negate(bc_length, bc);
+		return sum(ad_length, ad, bc_length, bc, h);
+	}
+}
+
+double Predicates::orient2d_exact(double ax, double ay, double bx, double by, double cx, double cy)
+{
+	double acx[2], acy[2], bcx[2], bcy[2], det[64];
+	const int acx_length = difference(ax, cx, acx), acy_length = difference(ay, cy, acy);
+	const int bcx_length = difference(bx, cx, bcx), bcy_length = difference(by, cy, bcy);
+	const int det_length = determinant(acx_length, acx, acy_length, acy, bcx_length, bcx, bcy_length, bcy, det);
+	return sign(det_length, det);
+}
+
+double Predicates::incircle_exact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+{
+	double adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+	const int adx_length = difference(ax, dx, adx), ady_length = difference(ay, dy, ady);
+	const int bdx_length = difference(bx, dx, bdx), bdy_length = difference(by, dy, bdy);
+	const int cdx_length = difference(cx, dx, cdx), cdy_length = difference(cy, dy, cdy);
+
+	// the squared distances to d
+	double lifts[3][16];
+	int lift_lengths[3];
+	const double* xs[3] = { adx, bdx, cdx };
+	const double* ys[3] = { ady, bdy, cdy };
+	const int x_lengths[3] = { adx_length, bdx_length, cdx_length };
+	const int y_lengths[3] = { ady_length, bdy_length, cdy_length };
+	for (int i = 0; i < 3; i++)
+	{
+		double xx[8], yy[8];
+		const int xx_length = multiply(x_lengths[i], xs[i], x_lengths[i], xs[i], xx);
+		const int yy_length = multiply(y_lengths[i], ys[i], y_lengths[i], ys[i], yy);
+		lift_lengths[i] = sum(xx_length, xx, yy_length, yy, lifts[i]);
+	}
+
+	// expands along the lifted column: lift_i * (x_j * y_k - x_k * y_j)
+	double result[PREDICATES_MAX_EXPANSION], buffer[PREDICATES_MAX_EXPANSION];
+	int result_length = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		const int j = (i + 1) % 3, k = (i + 2) % 3;
+		double minor[64], term[512];
+		const int minor_length = determinant(x_lengths[j], xs[j], x_lengths[k], xs[k],
+			y_lengths[j], ys[j], y_lengths[k], ys[k], minor);
+		const int term_length = multiply(lift_lengths[i], lifts[i], minor_length, minor, term);
+		if (result_length == 0)
+		{
+			std::copy(term, term + term_length, result);
+			result_length = term_length;
+			continue;
+		}
+		const int buffer_length = sum(result_length, result, term_length, term, buffer);
+		std::copy(buffer, buffer + buffer_length, result);
+		result_length = buffer_length;
+	}
+	return sign(result_length, result);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cmath>
+
+/**
+ * \brief Robust geometric predicates. (Shewchuk)
+ * The signs are always correct: a fast floating point evaluation is checked against its error bound
+ * and only recomputed with exact expansion arithmetic if it is too close to 0.
+ */
+namespace Predicates
+{
+	/**
+	 * \brief Evaluates the orientation of three points exactly. (used if the fast evaluation is not certain)
+	 * \return The sign of the orientation. (-1, 0 or 1)
+	 */
+	double orient2d_exact(double ax, double ay, double bx, double by, double cx, double cy);
+
+	/**
+	 * \brief Evaluates the in-circle test exactly. (used if the fast evaluation is not certain)
+	 * \return The sign of the in-circle test. (-1, 0 or 1)
+	 */
+	double incircle_exact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+	/**
+	 * \brief The relative error bound of the fast orientation. ((3 + 16 eps) eps with eps = 2^-53)
+	 */
+	const double ORIENT2D_ERROR_BOUND = (3.0 + 16.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16;
+
+	/**
+	 * \brief The relative error bound of the fast in-circle test. ((10 + 96 eps) eps with eps = 2^-53)
+	 */
+	const double INCIRCLE_ERROR_BOUND = (10.0 + 96.0 * 1.1102230246251565e-16) * 1.1102230246251565e-16;
+
+	/**
+	 * \brief Evaluates the orientation of three points.
+	 * \param ax The x coordinate of the first point.
+	 * \param ay The y coordinate of the first point.
+	 * \param bx The x coordinate of the second point.
+	 * \param by The y coordinate of the second point.
+	 * \param cx The x coordinate of the third point.
+	 * \param cy The y coordinate of the third point.
+	 * \return Positive if the points are counterclockwise, negative if clockwise and 0 if collinear.
+	 */
+	inline double orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+	{
+		const double left = (ax - cx) * (by - cy);
+		const double right = (ay - cy) * (bx - cx);
+		const double det = left - right;
+		const double bound = ORIENT2D_ERROR_BOUND * (std::abs(left) + std::abs(right));
+		if (det > bound || -det > bound) return det;
+		return orient2d_exact(ax, ay, bx, by, cx, cy);
+	}
+
+	/**
+	 * \brief Evaluates whether a point lies in the circumcircle of three counterclockwise points.
+	 * \param ax The x coordinate of the first point.
+	 * \param ay The y coordinate of the first point.
+	 * \param bx The x coordinate of the second point.
+	 * \param by The y coordinate of the second point.
+	 * \param cx The x coordinate of the third point.
+	 * \param cy The y coordinate of the third point.
+	 * \param dx The x coordinate of the tested point.
+	 * \param dy The y coordinate of the tested point.
+	 * \return Positive if the point lies inside, negative if outside and 0 if on the circle.
+	 */
+	inline double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+	{
+		const double adx = ax - dx, ady = ay - dy;
+		const double bdx = bx - dx, bdy = by - dy;
+		const double cdx = cx - dx, cdy = cy - dy;
+
+		const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		const double cdxady = cdx * ady, adxcdy = adx * cdy;
+		const double adxbdy = adx * bdy, bdxady = bdx * ady;
+		const double alift = adx * adx + ady * ady;
+		const double blift = bdx * bdx + bdy * bdy;
+		const double clift = cdx * cdx + cdy * cdy;
+
+		const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+		const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift
+			+ (std::abs(cdxady) + std::abs(adxcdy)) * blift
+			+ (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+		const double bound = INCIRCLE_ERROR_BOUND * permanent;
+		if (det > bound || -det > bound) return det;
+		return incircle_exact(ax, ay, bx, by, cx, cy, dx, dy);
+	}
+}
@@ -0,0 +1,145 @@
+#include "Quaternion.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "Mat4f.h"
+
+/* Above this dot product the rotations are so close that slerp is replaced by a normalized lerp: */
+#define SLERP_LERP_THRESHOLD 0.9995f
+
+Quaternion::Quaternion(float x, float y, float z, float w)
+	: x(x), y(y), z(z), w(w)
+{
+}
+
+Quaternion Quaternion::operator*(Quaternion q) const
+{
+	return {
+		w * q.x + x * q.w + y * q.z - z * q.y,
+		w * q.y - x * q.z + y * q.w + z * q.x,
+		w * q.z + x * q.y - y * q.x + z * q.w,
+		w * q.w - x * q.x - y * q.y - z * q.z
+	};
+}
+
+float Quaternion::dot(Quaternion q) const
+{
+	return x * q.x + y * q.y + z * q.z + w * q.w;
+}
+
+Quaternion Quaternion::conjugate() const
+{
+	return { -x, -y, -z, w };
+}
+
+Quaternion Quaternion::normalized() const
+{
+	const float inverse_length = 1.f / std::sqrt(dot(*this));
+	return { x * inverse_length, y * inverse_length, z * inverse_length, w * inverse_length };
+}
+
+Vec4f Quaternion::rotate(Vec4f v) const
+{
+	// v' = v + 2w (u x v) + 2 u x (u x v), with u being the vector part
+	const float tx = 2.f * (y * v.z - z * v.y);
+	const float ty = 2.f * (z * v.x - x * v.z);
+	const float tz = 2.f * (x * v.y - y * v.x);
+	return {
+		v.x + w * tx + (y * tz - z * ty),
+		v.y + w * ty + (z * tx - x * tz),
+		v.z + w * tz + (x * ty - y * tx),
+		v.w
+	};
+}
+
+Mat4f Quaternion::toMatrix() const
+{
+	return Mat4f::transformation(Vec4f(0, 0, 0, 0), *this);
+}
+
+bool Quaternion::operator==(Quaternion q) const
+{
+	return
+		std::abs(x - q.x) <= COMPARE_DELTA &&
+		std::abs(y - q.y) <= COMPARE_DELTA &&
+		std::abs(z - q.z) <= COMPARE_DELTA &&
+		std::abs(w - q.w) <= COMPARE_DELTA;
+}
+
+bool Quaternion::operator!=(Quaternion q) const
+{
+	return !(*this == q);
+}
+
+std::ostream& operator<<(std::ostream& os, Quaternion q)
+{
+	os << "Q(" << q.x << ", " << q.y << ", " << q.z << ", " << q.w << ")";
+	return os;
+}
+
+Quaternion Quaternion::fromAxisAngle(Vec4f axis, float angle)
+{
+	const float s = std::sin(angle / 2), c = std::cos(angle / 2);
+	return { axis.x * s, axis.y * s, axis.z * s, c };
+}
+
+Quaternion Quaternion::fromEuler(float angleX, float angleY, float angleZ)
+{
+	// expanded product of the three axis rotations (x * y * z), one sin/cos per half angle
+	const float sx = std::sin(angleX / 2), cx = std::cos(angleX / 2);
+	const float sy = std::sin(angleY / 2), cy = std::cos(angleY / 2);
+	const float sz = std::sin(angleZ / 2), cz = std::cos(angleZ / 2);
+	return {
+		sx * cy * cz + cx * sy * sz,
+		cx * sy * cz - sx * cy * sz,
+		cx * cy * sz + sx * sy * cz,
+		cx * cy * cz - sx * sy * sz
+	};
+}
+
+Quaternion Quaternion::slerp(Quaternion a, Quaternion b, float t)
+{
+	Quaternion result;
+	slerp(&a, &b, &t, &result, 1);
+	return result;
+}
+
+void Quaternion::slerp(const Quaternion* a, const Quaternion* b, const float* t, Quaternion* result, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const Quaternion qa = a[i], qb = b[i];
+		const float ti = t[i];
+
+		// takes the shortest arc
+		const float d = qa.dot(qb);
+		const float sign = d < 0.f ? -1.f : 1.f;
+		const float cos_theta = std::min(std::abs(d), 1.f);
+
+		// nearly equal rotations use the lerp weights, since sin(theta) is too small to divide by
+		const float theta = std::acos(cos_theta);
+		const float inverse_sin = 1.f / std::max(std::sin(theta), 1e-6f);
+		const bool lerp = cos_theta > SLERP_LERP_THRESHOLD;
+		const float wa = lerp ? 1.f - ti : std::sin((1.f - ti) * theta) * inverse_sin;
+		const float wb = sign * (lerp ? ti : std::sin(ti * theta) * inverse_sin);
+
+		Quaternion q(
+			wa * qa.x + wb * qb.x,
+			wa * qa.y + wb * qb.y,
+			wa * qa.z + wb * qb.z,
+			wa * qa.w + wb * qb.w
+		);
+		// only the lerp needs the normalization, but it keeps errors from accumulating either way
+		const float inverse_length = 1.f / std::sqrt(q.dot(q));
+		result[i] = { q.x * inverse_length, q.y * inverse_length, q.z * inverse_length, q.w * inverse_length };
+	}
+}
+
+void Quaternion::compose(const Quaternion* a, const Quaternion* b, Quaternion* result, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		result[i] = a[i] * b[i];
+	}
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+
+#include "Vec4f.h"
+
+struct Mat4f;
+
+/**
+ * \brief A quaternion (x, y, z, w) which represents a rotation.
+ */
+struct Quaternion
+{
+public:
+	/**
+	 * \brief The first component of the vector part.
+	 */
+	float x;
+
+	/**
+	 * \brief The second component of the vector part.
+	 */
+	float y;
+
+	/**
+	 * \brief The third component of the vector part.
+	 */
+	float z;
+
+	/**
+	 * \brief The scalar part.
+	 */
+	float w;
+
+public:
+	/**
+	 * \brief The constructor. (Defaults to the identity rotation)
+	 * \param x The first component of the vector part.
+	 * \param y The second component of the vector part.
+	 * \param z The third component of the vector part.
+	 * \param w The scalar part.
+	 */
+	Quaternion(float x = 0.f, float y = 0.f, float z = 0.f, float w = 1.f);
+
+public:
+	/**
+	 * \brief Returns the composition of two rotations. (The given rotation is applied first)
+	 * \param q The other quaternion.
+	 * \return The composed quaternion.
+	 */
+	Quaternion operator*(Quaternion q) const;
+
+	/**
+	 * \brief Returns the dot product of two quaternions.
+	 * \param q The other quaternion.
+	 * \return The dot product.
+	 */
+	float dot(Quaternion q) const;
+
+	/**
+	 * \brief Returns the conjugated quaternion. (The inverse rotation for unit quaternions)
+	 * \return The conjugated quaternion.
+	 */
+	Quaternion conjugate() const;
+
+	/**
+	 * \brief Returns the normalized quaternion.
+	 * \return The normalized quaternion.
+	 */
+	Quaternion normalized() const;
+
+	/**
+	 * \brief Rotates a point or vector.
+	 * \param v The point or vector.
+	 * \return The rotated point or vector.
+	 */
+	Vec4f rotate(Vec4f v) const;
+
+	/**
+	 * \brief Returns the rotation matrix of this unit quaternion.
+	 * \return The rotation matrix.
+	 */
+	Mat4f toMatrix() const;
+
+	/**
+	 * \brief Checks that the difference of each component is smaller or equal to 'COMPARE_DELTA'.
+	 * \param q The other quaternion.
+	 * \return Whether the quaternions are equal.
+	 */
+	bool operator==(Quaternion q) const;
+
+	/**
+	 * \brief Checks if at least one component has a higher difference than 'COMPARE_DELTA'.
+	 * \param q The other quaternion.
+	 * \return Whether the quaternions are not equal.
+	 */
+	bool operator!=(Quaternion q) const;
+
+public:
+	/**
+	 * \brief Adds the given Quaternion to an output stream.
+	 * \param os The output stream.
+	 * \param q The quaternion.
+	 * \return The output stream.
+	 */
+	friend std::ostream& operator<<(std::ostream& os, Quaternion q);
+
+public:
+	/**
+	 * \brief Returns a quaternion which performs a rotation around an axis.
+	 * \param axis The normalized rotation axis.
+	 * \param angle The rotation angle.
+	 * \return The quaternion.
+	 */
+	static Quaternion fromAxisAngle(Vec4f axis, float angle);
+
+	/**
+	 * \brief Returns a quaternion which performs the same rotation as 'Mat4f::rotation'.
+	 * \param angleX The rotation around the x-axis.
+	 * \param angleY The rotation around the y-axis.
+	 * \param angleZ The rotation around the z-axis.
+	 * \return The quaternion.
+	 */
+	static Quaternion fromEuler(float angleX = 0.f, float angleY = 0.f, float angleZ = 0.f);
+
+	/**
+	 * \brief Spherical linear interpolation between two unit quaternions along the shortest arc.
+	 * \param a The start rotation.
+	 * \param b The end rotation.
+	 * \param t The interpolation parameter. (0-1)
+	 * \return The interpolated rotation.
+	 */
+	static Quaternion slerp(Quaternion a, Quaternion b, float t);
+
+	/**
+	 * \brief Interpolates many rotation pairs at once.
+	 * Each pair still calls acos and sin, so the loop stays scalar and only saves the per call overhead.
+	 * \param a The start rotations.
+	 * \param b The end rotations.
+	 * \param t The interpolation parameters.
+	 * \param result The interpolated rotations. (Can alias 'a' or 'b')
+	 * \param count The number of rotations.
+	 */
+	static void slerp(const Quaternion* a, const Quaternion* b, const float* t, Quaternion* result, size_t count);
+
+	/**
+	 * \brief Composes many rotation pairs at once. (result[i] = a[i] * b[i])
+	 * \param a The outer rotations.
+	 * \param b The inner rotations.
+	 * \param result The composed rotations. (Can alias 'a' or 'b')
+	 * \param count The number of rotations.
+	 */
+	static void compose(const Quaternion* a, const Quaternion* b, Quaternion* result, size_t count);
+};
@@ -0,0 +1,161 @@
+#include "SparseMatrix.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "utilities/Parallel.h"
+
+SparseMatrix::SparseMatrix(uint32_t rows, uint32_t columns)
+	: columns(columns), row_begins(static_cast<size_t>(rows) + 1, 0)
+{
+}
+
+SparseMatrix::SparseMatrix(uint32_t rows, uint32_t columns, const std::vector<SparseEntry>& entries)
+	: columns(columns), row_begins(static_cast<size_t>(rows) + 1, 0)
+{
+	if (entries.size() >= 0xFFFFFFFFu)
+		throw std::invalid_argument("'SparseMatrix' should only be called with less than 2^32 entries.");
+
+	// counting sort of the entries into their rows
+	for (const SparseEntry& entry : entries)
+	{
+		if (entry.row >= rows || entry.column >= columns)
+			throw std::invalid_argument("'SparseMatrix' should only be called with entries inside of the matrix.");
+		row_begins[entry.row + 1]++;
+	}
+	for (uint32_t row = 0; row < rows; row++)
+		row_begins[row + 1] += row_begins[row];
+	std::vector<SparseEntry> sorted(entries.size());
+	std::vector<uint32_t> cursors(row_begins.begin(), row_begins.end() - 1);
+	for (const SparseEntry& entry : entries)
+		sorted[cursors[entry.row]++] = entry;
+
+	// sorts each row by the columns and sums the duplicates, the rows are compacted afterwards
+	std::vector<uint32_t> row_sizes(rows);
+	Utilities::parallel_for(rows, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t row = begin; row < end; row++)
+		{
+			SparseEntry* first = sorted.data() + row_begins[row];
+			SparseEntry* last = sorted.data() + row_begins[row + 1];
+			std::sort(first, last, [](const SparseEntry& a, const SparseEntry& b) { return a.column < b.column; });
+			SparseEntry* unique = first;
+			for (SparseEntry* entry = first; entry < last; entry++)
+			{
+				if (unique != first && (unique - 1)->column == entry->column)
+					(unique - 1)->value += entry->value;
+				else
+					*unique++ = *entry;
+			}
+			row_sizes[row] = static_cast<uint32_t>(unique - first);
+		}
+	}, 1024);
+
+	std::vector<uint32_t> sorted_begins(row_begins);
+	for (uint32_t row = 0; row < rows; row++)
+		row_begins[row + 1] = row_begins[row] + row_sizes[row];
+	column_indices.resize(row_begins.back());
+	values.resize(row_begins.back());
+	Utilities::parallel_for(rows, [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t row = begin; row < end; row++)
+		{
+			for (uint32_t i = 0; i < row_sizes[row]; i++)
+			{
+				const SparseEntry& entry = sorted[sorted_begins[row] + i];
+				column_indices[row_begins[row] + i] = entry.column;
+				values[row_begins[row] + i] = entry.value;
+			}
+		}
+	}, 1024);
+}
+
+uint32_t SparseMatrix::row_count() const
+{
+	return static_cast<uint32_t>(row_begins.size() - 1);
+}
+
+uint32_t SparseMatrix::column_count() const
+{
+	return columns;
+}
+
+size_t SparseMatrix::nonzero_count() const
+{
+	return values.size();
+}
+
+double SparseMatrix::get(uint32_t row, uint32_t column) const
+{
+	const auto first = column_indices.begin() + row_begins[row], last = column_indices.begin() + row_begins[row + 1];
+	const auto entry = std::lower_bound(first, last, column);
+	if (entry == last || *entry != column)
+		return 0.0;
+	return values[entry - column_indices.begin()];
+}
+
+std::vector<double> SparseMatrix::diagonal() const
+{
+	std::vector<double> result(row_count());
+	for (uint32_t row = 0; row < row_count(); row++)
+		result[row] = get(row, row);
+	return result;
+}
+
+void SparseMatrix::multiply(const double* x, double* y) const
+{
+	Utilities::parallel_for(row_count(), [&](size_t begin, size_t end, unsigned int)
+	{
+		for (size_t row = begin; row < end; row++)
+		{
+			double sum = 0.0;
+			for (uint32_t i = row_begins[row]; i < row_begins[row + 1]; i++)
+				sum += values[i] * x[column_indices[i]];
+			y[row] = sum;
+		}
+	}, 4096);
+}
+
+std::vector<double> SparseMatrix::multiply(const std::vector<double>& x) const
+{
+	if (x.size() != columns)
+		throw std::invalid_argument("'SparseMatrix::multiply' should only be called with one value per column.");
+	std::vector<double> y(row_count());
+	multiply(x.data(), y.data());
+	return y;
+}
+
+void SparseMatrix::scale(double factor)
+{
+	for (double& value : values)
+		value *= factor;
+}
+
+void SparseMatrix::add_to_diagonal(const std::vector<double>& diagonal_values)
+{
+	if (diagonal_values.size() != row_count())
+		throw std::invalid_argument("'SparseMatrix::add_to_diagonal' should only be called with one value per row.");
+	for (uint32_t row = 0; row < row_count(); row++)
+	{
+		const auto first = column_indices.begin() + row_begins[row], last = column_indices.begin() + row_begins[row + 1];
+		const auto entry = std::lower_bound(first, last, row);
+		if (entry == last || *entry != row)
+			throw std::invalid_argument("'SparseMatrix::add_to_diagonal' should only be called if all diagonal entries are stored.");
+		values[entry - column_indices.begin()] += diagonal_values[row];
+	}
+}
+
+const std::vector<uint32_t>& SparseMatrix::get_row_begins() const
+{
+	return row_begins;
+}
+
+const std::vector<uint32_t>& SparseMatrix::get_columns() const
+{
+	return column_indices;
+}
+
+const std::vector<double>& SparseMatrix::get_values() const
+{
+	return values;
+}
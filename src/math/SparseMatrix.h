@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * \brief An entry of a sparse matrix before the assembly.
+ */
+struct SparseEntry
+{
+	/**
+	 * \brief The row.
+	 */
+	uint32_t row;
+
+	/**
+	 * \brief The column.
+	 */
+	uint32_t column;
+
+	/**
+	 * \brief The value.
+	 */
+	double value;
+};
+
+/**
+ * \brief A sparse matrix in compressed sparse row (CSR) layout.
+ * The columns of each row are sorted and unique.
+ */
+class SparseMatrix
+{
+public:
+	/**
+	 * \brief The constructor for an empty matrix.
+	 * \param rows The number of rows.
+	 * \param columns The number of columns.
+	 */
+	SparseMatrix(uint32_t rows = 0, uint32_t columns = 0);
+
+	/**
+	 * \brief The constructor. Assembles the entries on all threads, entries at the same position are summed.
+	 * \param rows The number of rows.
+	 * \param columns The number of columns.
+	 * \param entries The entries. (in any order)
+	 */
+	SparseMatrix(uint32_t rows, uint32_t columns, const std::vector<SparseEntry>& entries);
+
+	/**
+	 * \brief Returns the number of rows.
+	 * \return The number of rows.
+	 */
+	uint32_t row_count() const;
+
+	/**
+	 * \brief Returns the number of columns.
+	 * \return The number of columns.
+	 */
+	uint32_t column_count() const;
+
+	/**
+	 * \brief Returns the number of stored entries.
+	 * \return The number of entries.
+	 */
+	size_t nonzero_count() const;
+
+	/**
+	 * \brief Returns an entry.
+	 * \param row The row.
+	 * \param column The column.
+	 * \return The value. (0 if it is not stored)
+	 */
+	double get(uint32_t row, uint32_t column) const;
+
+	/**
+	 * \brief Returns the diagonal.
+	 * \return The diagonal entries.
+	 */
+	std::vector<double> diagonal() const;
+
+	/**
+	 * \brief Multiplies the matrix with a vector on all threads.
+	 * \param x The vector. (one value per column)
+	 * \param y The product. (one value per row)
+	 */
+	void multiply(const double* x, double* y) const;
+
+	/**
+	 * \brief Multiplies the matrix with a vector on all threads.
+	 * \param x The vector. (one value per column)
+	 * \return The product. (one value per row)
+	 */
+	std::vector<double> multiply(const std::vector<double>& x) const;
+
+	/**
+	 * \brief Multiplies all entries with a factor.
+	 * \param factor The factor.
+	 */
+	void scale(double factor);
+
+	/**
+	 * \brief Adds values to the diagonal entries, which have to be stored.
+	 * \param diagonal_values The values. (one per row)
+	 */
+	void add_to_diagonal(const std::vector<double>& diagonal_values);
+
+	/**
+	 * \brief Returns the offset of each row in the columns and values. (one more than rows)
+	 * \return The offsets.
+	 */
+	const std::vector<uint32_t>& get_row_begins() const;
+
+	/**
+	 * \brief Returns the columns of the entries.
+	 * \return The columns.
+	 */
+	const std::vector<uint32_t>& get_columns() const;
+
+	/**
+	 * \brief Returns the values of the entries.
+	 * \return The values.
+	 */
+	const std::vector<double>& get_values() const;
+
+private:
+	/**
+	 * \brief The number of columns.
+	 */
+	uint32_t columns;
+
+	/**
+	 * \brief The offset of each row in 'column_indices' and 'values'. (one more than rows)
+	 */
+	std::vector<uint32_t> row_begins;
+
+	/**
+	 * \brief The columns of the entries.
+	 */
+	std::vector<uint32_t> column_indices;
+
+	/**
+	 * \brief The values of the entries.
+	 */
+	std::vector<double> values;
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "Vec4f.h"
+
+/**
+ * \brief A compact point or vector with 3 components.
+ * Used by the geometry algorithms, where the w checks of 'Vec4f' are too expensive.
+ */
+struct Vec3f
+{
+public:
+	/**
+	 * \brief The first component.
+	 */
+	float x;
+
+	/**
+	 * \brief The second component.
+	 */
+	float y;
+
+	/**
+	 * \brief The third component.
+	 */
+	float z;
+
+public:
+	/**
+	 * \brief The constructor.
+	 * \param x The first component.
+	 * \param y The second component.
+	 * \param z The third component.
+	 */
+	Vec3f(float x = 0.f, float y = 0.f, float z = 0.f)
+		: x(x), y(y), z(z)
+	{
+	}
+
+	/**
+	 * \brief The constructor. (Drops the fourth component)
+	 * \param v The point or vector.
+	 */
+	explicit Vec3f(Vec4f v)
+		: x(v.x), y(v.y), z(v.z)
+	{
+	}
+
+public:
+	/**
+	 * \brief Converts this to a point.
+	 * \return The point.
+	 */
+	Vec4f toPoint() const
+	{
+		return { x, y, z, 1 };
+	}
+
+	/**
+	 * \brief Converts this to a vector.
+	 * \return The vector.
+	 */
+	Vec4f toVector() const
+	{
+		return { x, y, z, 0 };
+	}
+
+	/**
+	 * \brief Returns the dot product.
+	 * \param v The other vector.
+	 * \return The dot product.
+	 */
+	float dot(Vec3f v) const
+	{
+		return x * v.x + y * v.y + z * v.z;
+	}
+
+	/**
+	 * \brief Returns the cross product.
+	 * \param v The other vector.
+	 * \return The cross product.
+	 */
+	Vec3f cross(Vec3f v) const
+	{
+		return { y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x };
+	}
+
+	/**
+	 * \brief The squared length.
+	 * \return The squared length.
+	 */
+	float squaredLength() const
+	{
+		return dot(*this);
+	}
+
+	/**
+	 * \brief The length.
+	 * \return The length.
+	 */
+	float length() const
+	{
+		return std::sqrt(dot(*this));
+	}
+
+public:
+	/**
+	 * \brief Returns the negated vector.
+	 * \return The negated vector.
+	 */
+	Vec3f operator-() const
+	{
+		return { -x, -y, -z };
+	}
+
+	/**
+	 * \brief Returns the component-wise sum.
+	 * \param v The other vector.
+	 * \return The sum.
+	 */
+	Vec3f operator+(Vec3f v) const
+	{
+		return { x + v.x, y + v.y, z + v.z };
+	}
+
+	/**
+	 * \brief Returns the component-wise subtraction.
+	 * \param v The other vector.
+	 * \return The subtraction.
+	 */
+	Vec3f operator-(Vec3f v) const
+	{
+		return { x - v.x, y - v.y, z - v.z };
+	}
+
+	/**
+	 * \brief Multiplies all components with the scalar.
+	 * \param scalar The scalar.
+	 * \return The multiplied vector.
+	 */
+	Vec3f operator*(float scalar) const
+	{
+		return { x * scalar, y * scalar, z * scalar };
+	}
+
+	/**
+	 * \brief Allows access to the individual components.
+	 * \param i The index. (0-2)
+	 * \return The component.
+	 */
+	float& operator[](int i)
+	{
+		return (&x)[i];
+	}
+
+	/**
+	 * \brief Allows access to the individual components.
+	 * \param i The index. (0-2)
+	 * \return The component.
+	 */
+	float operator[](int i) const
+	{
+		return (&x)[i];
+	}
+
+public:
+	/**
+	 * \brief Returns the component-wise minimum.
+	 * \param a The first vector.
+	 * \param b The second vector.
+	 * \return The minimum.
+	 */
+	static Vec3f min(Vec3f a, Vec3f b)
+	{
+		return { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) };
+	}
+
+	/**
+	 * \brief Returns the component-wise maximum.
+	 * \param a The first vector.
+	 * \param b The second vector.
+	 * \return The maximum.
+	 */
+	static Vec3f max(Vec3f a, Vec3f b)
+	{
+		return { std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) };
+	}
+};
@@ -1,5 +1,6 @@
 #include "Vec4f.h"
 
+#include <cmath>
 #include <iostream>
 
 Vec4f::Vec4f(float x, float y, float z, float w)
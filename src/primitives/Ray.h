@@ -0,0 +1,51 @@
+#pragma once
+
+#include "math/Vec4f.h"
+
+/**
+ * \brief A ray.
+ */
+struct Ray
+{
+	/**
+	 * \brief The origin. (point)
+	 */
+	Vec4f origin;
+
+	/**
+	 * \brief The direction. (vector)
+	 */
+	Vec4f direction;
+
+	/**
+	 * \brief The constructor.
+	 * \param origin The origin.
+	 * \param direction The direction.
+	 */
+	Ray(Vec4f origin = { 0, 0, 0, 1 }, Vec4f direction = { 0, 0, 1, 0 })
+		: origin(origin), direction(direction)
+	{
+	}
+
+	/**
+	 * \brief Returns a point on the ray.
+	 * \param t The distance in units of the direction length.
+	 * \return The point.
+	 */
+	Vec4f at(float t) const
+	{
+		return { origin.x + direction.x * t, origin.y + direction.y * t, origin.z + direction.z * t, 1 };
+	}
+
+	/**
+	 * \brief Prints the ray.
+	 * \param os The output stream.
+	 * \param ray The ray.
+	 * \return The output stream.
+	 */
+	friend std::ostream& operator<<(std::ostream& os, Ray ray)
+	{
+		os << "R(" << ray.origin << ", " << ray.direction << ")";
+		return os;
+	}
+};
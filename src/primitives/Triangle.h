@@ -3,7 +3,12 @@
 #include <iomanip>
 #include "Vertex.h"
 
+#include "math/Vec3f.h"
 #include "primitives/Barycentric.h"
+#include "primitives/Ray.h"
+
+/* Distances to the plane of the other triangle below this fraction of the triangle size count as 0: */
+#define TRIANGLE_INTERSECTION_EPSILON 1e-6f
 
 /**
  * \brief A triangle.
@@ -85,15 +90,255 @@ struct Triangle
 		float l2 = (point - c2).squaredLength();
 		float l3 = (point - c3).squaredLength();
 
-		// smallest distance
-		float min = std::min({l1, l2, l3});
-
 		// returns closest point
 		if (l1 <= l2 && l1 <= l3) return c1;
 		if (l2 <= l3) return c2;
 		return c3;
 	}
 
+	/**
+	 * \brief Interpolates the attributes of the vertices.
+	 * \param barycentric The barycentric coordinates.
+	 * \return The vertex at the barycentric coordinates.
+	 */
+	Vertex interpolate(Barycentric barycentric) const
+	{
+		const float wa = barycentric.alpha, wb = barycentric.beta, wc = barycentric.gamma;
+		const auto mix = [&](Vec4f a, Vec4f b, Vec4f c) -> Vec4f
+		{
+			return { wa * a.x + wb * b.x + wc * c.x, wa * a.y + wb * b.y + wc * c.y,
+				wa * a.z + wb * b.z + wc * c.z, wa * a.w + wb * b.w + wc * c.w };
+		};
+		const Vertex& a = vertices[0], & b = vertices[1], & c = vertices[2];
+		return Vertex(mix(a.position, b.position, c.position), mix(a.color, b.color, c.color),
+			mix(a.normal, b.normal, c.normal),
+			TexCoord(wa * a.uv.u + wb * b.uv.u + wc * c.uv.u, wa * a.uv.v + wb * b.uv.v + wc * c.uv.v));
+	}
+
+	/**
+	 * \brief Returns the barycentric coordinates of the closest point in the triangle. (in 3D)
+	 * \param point The other point.
+	 * \return The barycentric coordinates of the closest point.
+	 */
+	Barycentric closest_barycentric(Vec4f point) const
+	{
+		return closest_barycentric(Vec3f(point), Vec3f(vertices[0].position), Vec3f(vertices[1].position), Vec3f(vertices[2].position));
+	}
+
+	/**
+	 * \brief Returns the barycentric coordinates of the closest point in a triangle. (in 3D)
+	 * \param p The point.
+	 * \param a The first vertex of the triangle.
+	 * \param b The second vertex of the triangle.
+	 * \param c The third vertex of the triangle.
+	 * \return The barycentric coordinates of the closest point.
+	 */
+	static Barycentric closest_barycentric(Vec3f p, Vec3f a, Vec3f b, Vec3f c)
+	{
+		// Ericson, Real-Time Collision Detection, 5.1.5: checks the voronoi regions of the vertices and edges
+		const Vec3f ab = b - a, ac = c - a, ap = p - a;
+		const float d1 = ab.dot(ap), d2 = ac.dot(ap);
+		if (d1 <= 0.f && d2 <= 0.f) return Barycentric(1, 0, 0);
+
+		const Vec3f bp = p - b;
+		const float d3 = ab.dot(bp), d4 = ac.dot(bp);
+		if (d3 >= 0.f && d4 <= d3) return Barycentric(0, 1, 0);
+
+		const float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+		{
+			const float v = d1 / (d1 - d3);
+			return Barycentric(1 - v, v, 0);
+		}
+
+		const Vec3f cp = p - c;
+		const float d5 = ab.dot(cp), d6 = ac.dot(cp);
+		if (d6 >= 0.f && d5 <= d6) return Barycentric(0, 0, 1);
+
+		const float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+		{
+			const float w = d2 / (d2 - d6);
+			return Barycentric(1 - w, 0, w);
+		}
+
+		const float va = d3 * d6 - d5 * d4;
+		if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+		{
+			const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			return Barycentric(0, 1 - w, w);
+		}
+
+		// inside the face region (degenerate triangles fall back to the first vertex)
+		const float sum = va + vb + vc;
+		if (sum == 0.f) return Barycentric(1, 0, 0);
+		const float v = vb / sum, w = vc / sum;
+		return Barycentric(1 - v - w, v, w);
+	}
+
+	/**
+	 * \brief Intersects a ray with the triangle.
+	 * \param ray The ray.
+	 * \param t The distance along the ray. (only set on a hit)
+	 * \param barycentric The barycentric coordinates of the hit. (only set on a hit)
+	 * \return Whether the ray hits the triangle.
+	 */
+	bool intersect(Ray ray, float& t, Barycentric& barycentric) const
+	{
+		return intersect(Vec3f(ray.origin), Vec3f(ray.direction),
+			Vec3f(vertices[0].position), Vec3f(vertices[1].position), Vec3f(vertices[2].position), t, barycentric);
+	}
+
+	/**
+	 * \brief Intersects a ray with a triangle. (Moller-Trumbore, both sides)
+	 * \param origin The ray origin.
+	 * \param direction The ray direction.
+	 * \param a The first vertex of the triangle.
+	 * \param b The second vertex of the triangle.
+	 * \param c The third vertex of the triangle.
+	 * \param t The distance along the ray. (only set on a hit)
+	 * \param barycentric The barycentric coordinates of the hit. (only set on a hit)
+	 * \return Whether the ray hits the triangle.
+	 */
+	static bool intersect(Vec3f origin, Vec3f direction, Vec3f a, Vec3f b, Vec3f c, float& t, Barycentric& barycentric)
+	{
+		const Vec3f ab = b - a, ac = c - a;
+		const Vec3f p = direction.cross(ac);
+		const float det = ab.dot(p);
+		if (det == 0.f) return false;
+		const float inverse_det = 1.f / det;
+
+		const Vec3f s = origin - a;
+		const float u = s.dot(p) * inverse_det;
+		if (u < 0.f || u > 1.f) return false;
+
+		const Vec3f q = s.cross(ab);
+		const float v = direction.dot(q) * inverse_det;
+		if (v < 0.f || u + v > 1.f) return false;
+
+		const float distance = ac.dot(q) * inverse_det;
+		if (distance < 0.f) return false;
+
+		t = distance;
+		barycentric = Barycentric(1 - u - v, u, v);
+		return true;
+	}
+
+	/**
+	 * \brief Whether the triangle intersects or touches another triangle.
+	 * \param other The other triangle.
+	 * \return Whether the triangles intersect.
+	 */
+	bool intersects(const Triangle& other) const
+	{
+		const Vec3f a[3] = { Vec3f(vertices[0].position), Vec3f(vertices[1].position), Vec3f(vertices[2].position) };
+		const Vec3f b[3] = { Vec3f(other.vertices[0].position), Vec3f(other.vertices[1].position), Vec3f(other.vertices[2].position) };
+		return intersects(a, b);
+	}
+
+	/**
+	 * \brief Whether two triangles intersect or touch. (Moller 1997, coplanar triangles are tested in 2D)
+	 * Degenerate triangles never intersect.
+	 * \param a The vertices of the first triangle.
+	 * \param b The vertices of the second triangle.
+	 * \return Whether the triangles intersect.
+	 */
+	static bool intersects(const Vec3f* a, const Vec3f* b)
+	{
+		// the signed distances of the vertices of one triangle to the plane of the other
+		const auto plane_distances = [](const Vec3f* plane, const Vec3f* points, Vec3f& normal, float* d)
+		{
+			normal = (plane[1] - plane[0]).cross(plane[2] - plane[0]);
+			const float length = normal.length();
+			const float epsilon = TRIANGLE_INTERSECTION_EPSILON * length * std::sqrt(length);
+			for (int i = 0; i < 3; i++)
+			{
+				d[i] = normal.dot(points[i] - plane[0]);
+				if (std::abs(d[i]) <= epsilon) d[i] = 0.f;
+			}
+			const bool separated = (d[0] > 0.f && d[1] > 0.f && d[2] > 0.f) || (d[0] < 0.f && d[1] < 0.f && d[2] < 0.f);
+			return length > 0.f && !separated;
+		};
+		Vec3f na, nb;
+		float da[3], db[3];
+		if (!plane_distances(b, a, nb, da) || !plane_distances(a, b, na, db)) return false;
+
+		if (da[0] == 0.f && da[1] == 0.f && da[2] == 0.f)
+			return intersects_coplanar(a, b, na);
+
+		// both triangles cut the intersection line of the planes in an interval, which is projected on its largest axis
+		const Vec3f direction = na.cross(nb);
+		int axis = std::abs(direction.x) > std::abs(direction.y) ? 0 : 1;
+		if (std::abs(direction.z) > std::abs(direction[axis])) axis = 2;
+
+		const auto interval = [axis](const Vec3f* v, const float* d, float& t0, float& t1)
+		{
+			// the vertex alone on its side of the other plane
+			int alone = 0;
+			if (d[0] * d[1] > 0.f) alone = 2;
+			else if (d[0] * d[2] > 0.f) alone = 1;
+			else if (d[1] * d[2] > 0.f || d[0] != 0.f) alone = 0;
+			else if (d[1] != 0.f) alone = 1;
+			else alone = 2;
+			const int u = (alone + 1) % 3, w = (alone + 2) % 3;
+			const float p = v[alone][axis];
+			t0 = p + (v[u][axis] - p) * d[alone] / (d[alone] - d[u]);
+			t1 = p + (v[w][axis] - p) * d[alone] / (d[alone] - d[w]);
+			if (t0 > t1) std::swap(t0, t1);
+		};
+		float a0, a1, b0, b1;
+		interval(a, da, a0, a1);
+		interval(b, db, b0, b1);
+		return a1 >= b0 && b1 >= a0;
+	}
+
+	/**
+	 * \brief Whether two triangles in the same plane intersect or touch.
+	 * \param a The vertices of the first triangle.
+	 * \param b The vertices of the second triangle.
+	 * \param normal The normal of the plane.
+	 * \return Whether the triangles intersect.
+	 */
+	static bool intersects_coplanar(const Vec3f* a, const Vec3f* b, Vec3f normal)
+	{
+		// projects along the largest axis of the normal
+		int axis = std::abs(normal.x) > std::abs(normal.y) ? 0 : 1;
+		if (std::abs(normal.z) > std::abs(normal[axis])) axis = 2;
+		const int i = (axis + 1) % 3, j = (axis + 2) % 3;
+		const auto orient = [i, j](Vec3f p, Vec3f q, Vec3f r)
+		{
+			return (q[i] - p[i]) * (r[j] - p[j]) - (q[j] - p[j]) * (r[i] - p[i]);
+		};
+
+		// crossing or touching edges
+		for (int e = 0; e < 3; e++)
+		{
+			const Vec3f p = a[e], q = a[(e + 1) % 3];
+			for (int f = 0; f < 3; f++)
+			{
+				const Vec3f r = b[f], s = b[(f + 1) % 3];
+				const float o1 = orient(p, q, r), o2 = orient(p, q, s), o3 = orient(r, s, p), o4 = orient(r, s, q);
+				if (o1 == 0.f && o2 == 0.f)
+				{
+					// collinear edges overlap if their bounds do
+					if (std::max(p[i], q[i]) >= std::min(r[i], s[i]) && std::max(r[i], s[i]) >= std::min(p[i], q[i])
+						&& std::max(p[j], q[j]) >= std::min(r[j], s[j]) && std::max(r[j], s[j]) >= std::min(p[j], q[j]))
+						return true;
+					continue;
+				}
+				if (o1 * o2 <= 0.f && o3 * o4 <= 0.f) return true;
+			}
+		}
+
+		// one triangle contains the other
+		const auto contains = [&orient](const Vec3f* t, Vec3f p)
+		{
+			const float o1 = orient(t[0], t[1], p), o2 = orient(t[1], t[2], p), o3 = orient(t[2], t[0], p);
+			return (o1 >= 0.f && o2 >= 0.f && o3 >= 0.f) || (o1 <= 0.f && o2 <= 0.f && o3 <= 0.f);
+		};
+		return contains(b, a[0]) || contains(a, b[0]);
+	}
+
 	/**
 	 * \brief Calculates the point of this triangle and barycentric coordinates.
 	 * \param barycentric The barycentric coordinates.
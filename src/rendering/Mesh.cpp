@@ -11,8 +11,10 @@
 
 #include "tiny_obj_loader.h"
 
+#include "geometry/SpatialSort.h"
+
 Mesh::Mesh()
-	: Shader("simple.vert", "simple.frag"), vertices_num(0)
+	: Shader("simple.vert", "simple.frag"), vertices_num(0), half_edge_mesh_built(false)
 {
 	// creates the vao
 	glGenVertexArrays(1, &vao);
@@ -69,6 +71,18 @@ void Mesh::render(Mat4f model_matrix) const
 
 void Mesh::uploadData(const std::vector<Triangle>& triangles)
 {
+	// the triangles have no indices, so the adjacency is only built from the merged positions if it is used
+	half_edge_mesh = HalfEdgeMesh();
+	half_edge_mesh_built = false;
+
+	uploadTriangles(triangles);
+}
+
+void Mesh::uploadTriangles(const std::vector<Triangle>& triangles)
+{
+	// keeps the triangles for the geometric queries
+	this->triangles = triangles;
+
 	// binds the buffer
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
@@ -87,6 +101,9 @@ void Mesh::uploadData(const char* file_name, const char* source_dir)
 
 	std::vector<Triangle> triangles;
 
+	// The position index of each triangle corner for the adjacency:
+	std::vector<uint32_t> indices;
+
 	// Define buffers to load the data:
 	tinyobj::attrib_t attrib;
 	std::vector<tinyobj::shape_t> shapes;
@@ -132,6 +149,7 @@ void Mesh::uploadData(const char* file_name, const char* source_dir)
 			{
 				// access to vertex
 				tinyobj::index_t idx = shape.mesh.indices[index_offset + v];
+				indices.push_back(static_cast<uint32_t>(idx.vertex_index));
 
 				// Copy vertex position into triangle:
 				std::memcpy(&triangle[v].position, &attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 0],
@@ -164,6 +182,47 @@ void Mesh::uploadData(const char* file_name, const char* source_dir)
 		}
 	}
 
+	// builds the adjacency from the shared positions of the obj
+	std::vector<Vec3f> positions(attrib.vertices.size() / 3);
+	for (size_t i = 0; i < positions.size(); i++)
+		positions[i] = Vec3f(attrib.vertices[3 * i + 0], attrib.vertices[3 * i + 1], attrib.vertices[3 * i + 2]);
+
+	half_edge_mesh = HalfEdgeMesh(std::move(indices), std::move(positions));
+	half_edge_mesh_built = true;
+
 	// uploads the triangles
-	uploadData(triangles);
+	uploadTriangles(triangles);
+}
+
+void Mesh::sort_spatially(bool renumber_vertices)
+{
+	if (triangles.empty())
+		return;
+
+	// moves the corners of the adjacency along, so its face ids stay equal to the triangle ids
+	std::vector<uint32_t> indices = get_half_edge_mesh().get_indices();
+	std::vector<Vec3f> positions = get_half_edge_mesh().get_positions();
+	std::vector<Triangle> sorted = triangles;
+	SpatialSort::sort_triangles(sorted, indices);
+	if (renumber_vertices)
+		SpatialSort::sort_vertices(indices, positions);
+	half_edge_mesh = HalfEdgeMesh(std::move(indices), std::move(positions));
+
+	// uploads the triangles
+	uploadTriangles(sorted);
+}
+
+const std::vector<Triangle>& Mesh::get_triangles() const
+{
+	return triangles;
+}
+
+const HalfEdgeMesh& Mesh::get_half_edge_mesh() const
+{
+	if (!half_edge_mesh_built)
+	{
+		half_edge_mesh = HalfEdgeMesh::from_triangles(triangles);
+		half_edge_mesh_built = true;
+	}
+	return half_edge_mesh;
 }
\ No newline at end of file
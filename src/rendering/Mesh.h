@@ -12,6 +12,9 @@
 // Include Triangle primitive
 #include "primitives/Triangle.h"
 
+// Include the adjacency of the triangles
+#include "geometry/HalfEdgeMesh.h"
+
 /**
  * \brief A mesh.
  */
@@ -59,7 +62,35 @@ public:
 	 * \param source_dir The directory of the .obj file.
 	 */
 	void uploadData(const char* file_name, const char* source_dir = CMAKE_SOURCE_DIR "/models/");
+
+	/**
+	 * \brief Sorts the triangles along the Morton curve and uploads them again. (see 'SpatialSort')
+	 * Neighbouring triangles then share cache lines, which speeds up later passes over meshes that are stored in
+	 * a random order, but the sort costs time and changes the triangle ids, so it is only done on request.
+	 * \param renumber_vertices Whether the vertices of the adjacency are renumbered in the new order as well.
+	 */
+	void sort_spatially(bool renumber_vertices = false);
+
+	/**
+	 * \brief Returns the triangles of the last upload. (e.g. to build a 'BVH')
+	 * \return The triangles.
+	 */
+	const std::vector<Triangle>& get_triangles() const;
+
+	/**
+	 * \brief Returns the adjacency of the triangles of the last upload. (face ids equal triangle ids)
+	 * Triangles which were uploaded without an obj-file get their adjacency on the first call, so meshes which are
+	 * only rendered do not pay for it.
+	 * \return The half-edge mesh.
+	 */
+	const HalfEdgeMesh& get_half_edge_mesh() const;
 protected:
+	/**
+	 * \brief Keeps the triangles and uploads them to the vertex buffer object.
+	 * \param triangles The triangles.
+	 */
+	void uploadTriangles(const std::vector<Triangle>& triangles);
+
 	/**
 	 * \brief The vertex array object.
 	 */
@@ -74,4 +105,19 @@ protected:
 	 * \brief The number of vertices
 	 */
 	unsigned int vertices_num;
+
+	/**
+	 * \brief The triangles.
+	 */
+	std::vector<Triangle> triangles;
+
+	/**
+	 * \brief The adjacency of the triangles. (built by 'get_half_edge_mesh' if it is missing)
+	 */
+	mutable HalfEdgeMesh half_edge_mesh;
+
+	/**
+	 * \brief Whether the adjacency belongs to the triangles.
+	 */
+	mutable bool half_edge_mesh_built;
 };
@@ -2,6 +2,9 @@
 
 #include "settings.h"
 #include "math/Mat4f.h"
+#include "geometry/HandleGrid.h"
+#include "geometry/RayQuery.h"
+#include "primitives/Ray.h"
 
 /**
  * \brief Several utilities.
@@ -59,7 +62,7 @@ namespace Utilities
 	}
 
 	/**
-	 * \brief Find the nearest point from another point.
+	 * \brief Find the nearest point from another point. (a linear search, see 'HandleGrid' for many points)
 	 * \param points The points.
 	 * \param point_count The point count.
 	 * \param pos The other point.
@@ -68,14 +71,32 @@ namespace Utilities
 	 */
 	inline int find_nearest(Vec4f* points[], int point_count, Vec4f pos, int dimensions)
 	{
+		// compares squared distances, each computed once
+		const auto squared_distance = [&](int i)
+		{
+			float distance = 0.f;
+			for (int d = 0; d < dimensions; d++)
+			{
+				const float delta = (*points[i])[d] - pos[d];
+				distance += delta * delta;
+			}
+			return distance;
+		};
+
+		if (point_count <= 0)
+			return -1;
+
 		// takes the last point first
 		// so that the point in the barycentric coordinates demo has priority over the vertices
 		int iNearest = point_count-1;
+		float nearest_distance = squared_distance(iNearest);
 		for (int i=point_count-2; i>=0; i--)
 		{
-			if (points[i]->distanceTo(pos, dimensions) < points[iNearest]->distanceTo(pos, dimensions))
+			const float distance = squared_distance(i);
+			if (distance < nearest_distance)
 			{
 				iNearest = i;
+				nearest_distance = distance;
 			}
 		}
 		return iNearest;
@@ -95,6 +116,65 @@ namespace Utilities
 		return p0 + d * t;
 	}
 
+	/**
+	 * \brief Returns the ray through the mouse position.
+	 * \param modelMatrix The model matrix that is applied to the scene.
+	 * \return The ray. (in model space)
+	 */
+	inline Ray get_mouse_ray(Mat4f modelMatrix)
+	{
+		const Mat4f inverse = modelMatrix.inverse();
+		return Ray(inverse * get_mouse_position(), inverse * Vec4f(0, 0, 1, 0));
+	}
+
+	/**
+	 * \brief Finds the triangle under the mouse.
+	 * \param bvh The bounding volume hierarchy of the mesh.
+	 * \param modelMatrix The model matrix that is applied to the mesh.
+	 * \param hit The hit triangle and its barycentric coordinates.
+	 * \return Whether a triangle is under the mouse.
+	 */
+	inline bool pick_with_mouse(const BVH& bvh, Mat4f modelMatrix, RayHit& hit)
+	{
+		if (bvh.empty()) return false;
+
+		// the projection is orthographic, so the ray starts in front of the whole mesh
+		Ray ray = get_mouse_ray(modelMatrix);
+		const BVHNode& root = bvh.get_nodes()[0];
+		const Vec3f center = (Vec3f(root.bounds_min[0], root.bounds_min[1], root.bounds_min[2]) +
+			Vec3f(root.bounds_max[0], root.bounds_max[1], root.bounds_max[2])) * 0.5f;
+		const float radius = (Vec3f(root.bounds_max[0], root.bounds_max[1], root.bounds_max[2]) - center).length();
+		const float direction_length = Vec3f(ray.direction).length();
+		const float offset = ((center - Vec3f(ray.origin)).length() + radius) / direction_length;
+		ray.origin = ray.at(-offset);
+
+		if (!RayQuery(bvh).intersect(ray, hit)) return false;
+		hit.distance -= offset;
+		return true;
+	}
+
+	/**
+	 * \brief Returns where the mouse points to.
+	 * \param modelMatrix The model matrix that is applied to the scene.
+	 * \param surface The mesh under the mouse. (The z=0 plane if nullptr or not under the mouse)
+	 * \return The position. (in model space)
+	 */
+	inline Vec4f get_mouse_target(Mat4f modelMatrix, const BVH* surface = nullptr)
+	{
+		const Ray ray = get_mouse_ray(modelMatrix);
+		RayHit hit;
+		if (surface != nullptr && pick_with_mouse(*surface, modelMatrix, hit))
+		{
+			return ray.at(hit.distance);
+		}
+		return project_onto_plane(
+			ray.origin,
+			ray.direction,
+			Vec4f(0, 0, -1, 0), 
+			Vec4f()
+		);
+	}
+
 	/**
 	 * Mouses the nearest point with the mouse.
 	 *
@@ -103,18 +183,14 @@ namespace Utilities
 	 * @param modelMatrix The model matrix that is applied to the points.
 	 * @param mouseButton The mouse button.
 	 * @param currently_dragging Which point is being dragged.
+	 * @param surface The mesh the points are moved on. (The z=0 plane if nullptr or not under the mouse)
 	 */
-	inline bool move_with_mouse(Vec4f* points[], int pointCount, Mat4f modelMatrix, ImGuiMouseButton mouseButton, int& currently_dragging)
+	inline bool move_with_mouse(Vec4f* points[], int pointCount, Mat4f modelMatrix, ImGuiMouseButton mouseButton, int& currently_dragging,
+		const BVH* surface = nullptr)
 	{
 		if (ImGui::IsMouseDown(mouseButton) && !ImGui::GetIO().WantCaptureMouse)
 		{
-			Vec4f mousePos = modelMatrix.inverse() * get_mouse_position();
-			mousePos = project_onto_plane(
-				mousePos, 
-				modelMatrix.inverse() * Vec4f(0, 0, 1, 0), 
-				Vec4f(0, 0, -1, 0), 
-				Vec4f()
-			);
+			const Vec4f mousePos = get_mouse_target(modelMatrix, surface);
 			if (currently_dragging == -1)
 			{
 				currently_dragging = find_nearest(points, pointCount, mousePos, 3);
@@ -126,4 +202,35 @@ namespace Utilities
 		return false;
 	}
 
+	/**
+	 * \brief Moves the handle nearest to the mouse on the screen with the mouse.
+	 * \param handles The handles.
+	 * \param modelMatrix The model matrix that is applied to the handles.
+	 * \param mouseButton The mouse button.
+	 * \param currently_dragging Which handle is being dragged.
+	 * \param surface The mesh the handles are moved on. (The z=0 plane if nullptr or not under the mouse)
+	 * \param max_distance The maximum distance in pixels between the mouse and a handle which starts dragging.
+	 * \return Whether a handle was moved.
+	 */
+	inline bool move_with_mouse(HandleGrid& handles, Mat4f modelMatrix, ImGuiMouseButton mouseButton, int& currently_dragging,
+		const BVH* surface = nullptr, float max_distance = std::numeric_limits<float>::infinity())
+	{
+		if (ImGui::IsMouseDown(mouseButton) && !ImGui::GetIO().WantCaptureMouse)
+		{
+			handles.set_model_matrix(modelMatrix);
+			if (currently_dragging == -1)
+			{
+				const Vec4f mouse = get_mouse_position();
+				const uint32_t nearest = handles.find_nearest(mouse.x, mouse.y, max_distance);
+				if (nearest == HandleGrid::INVALID)
+					return false;
+				currently_dragging = static_cast<int>(nearest);
+			}
+			handles.move(static_cast<uint32_t>(currently_dragging), get_mouse_target(modelMatrix, surface));
+			return true;
+		}
+		currently_dragging = -1;
+		return false;
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Several utilities.
+ */
+namespace Utilities
+{
+	/**
+	 * \brief Returns the number of worker threads used by 'parallel_for'.
+	 * \return The number of threads. (At least 1)
+	 */
+	inline unsigned int thread_count()
+	{
+		const unsigned int count = std::thread::hardware_concurrency();
+		return count == 0 ? 1 : count;
+	}
+
+	/**
+	 * \brief Calls a function for chunks of the range [0, count) on all threads.
+	 * The chunks are handed out dynamically, so uneven work per element is balanced.
+	 * \param count The number of elements.
+	 * \param function The function, called with (begin, end, thread index).
+	 * \param grain The number of elements per chunk.
+	 */
+	template <typename Function>
+	void parallel_for(size_t count, Function function, size_t grain = 1024)
+	{
+		grain = std::max<size_t>(grain, 1);
+		const size_t chunks = (count + grain - 1) / grain;
+		const unsigned int threads = static_cast<unsigned int>(std::min<size_t>(thread_count(), chunks));
+		if (threads <= 1)
+		{
+			if (count > 0)
+				function(static_cast<size_t>(0), count, 0u);
+			return;
+		}
+
+		std::atomic<size_t> next(0);
+		const auto worker = [&](unsigned int thread)
+		{
+			for (size_t begin = next.fetch_add(grain); begin < count; begin = next.fetch_add(grain))
+			{
+				function(begin, std::min(begin + grain, count), thread);
+			}
+		};
+
+		// the calling thread works as thread 0
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+		for (unsigned int thread = 1; thread < threads; thread++)
+		{
+			workers.emplace_back(worker, thread);
+		}
+		worker(0);
+		for (std::thread& t : workers)
+		{
+			t.join();
+		}
+	}
+}
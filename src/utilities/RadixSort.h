@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Parallel.h"
+
+/* The number of bits of the digits sorted per pass: */
+#define RADIX_SORT_DIGIT_BITS 8
+
+/* The minimum number of keys per block, below which the sort stays on one thread: */
+#define RADIX_SORT_MIN_BLOCK 65536
+
+namespace Utilities
+{
+	/**
+	 * \brief Sorts keys by a range of their bits. (least significant digit radix sort, stable)
+	 * The keys are split into one block per thread. Each pass counts the digits of every block in parallel,
+	 * turns the counts into the output offsets of each block and digit and scatters the blocks in parallel.
+	 * Since the offsets only depend on the counts, the result is the same for any number of threads.
+	 * \param keys The keys.
+	 * \param values The values which are moved along with the keys. (nullptr or one per key)
+	 * \param first_bit The first bit of the sort key.
+	 * \param last_bit The bit after the last bit of the sort key.
+	 */
+	inline void radix_sort(std::vector<uint64_t>& keys, std::vector<uint32_t>* values, int first_bit, int last_bit)
+	{
+		const size_t digits = static_cast<size_t>(1) << RADIX_SORT_DIGIT_BITS;
+		const uint64_t mask = digits - 1;
+		const size_t count = keys.size();
+		const size_t block_size = std::max<size_t>(RADIX_SORT_MIN_BLOCK, (count + thread_count() - 1) / thread_count());
+		const size_t blocks = (count + block_size - 1) / block_size;
+
+		std::vector<uint64_t> buffer(count);
+		std::vector<uint32_t> value_buffer(values != nullptr ? count : 0);
+		std::vector<size_t> offsets(blocks * digits);
+		for (int shift = first_bit; shift < last_bit; shift += RADIX_SORT_DIGIT_BITS)
+		{
+			// counts the digits of each block
+			parallel_for(blocks, [&](size_t begin, size_t end, unsigned int)
+			{
+				for (size_t block = begin; block < end; block++)
+				{
+					size_t* counts = &offsets[block * digits];
+					std::fill(counts, counts + digits, static_cast<size_t>(0));
+					const size_t last = std::min(count, (block + 1) * block_size);
+					for (size_t i = block * block_size; i < last; i++)
+						counts[(keys[i] >> shift) & mask]++;
+				}
+			}, 1);
+
+			// the blocks write each digit one after another, so equal keys keep their order
+			size_t offset = 0;
+			for (size_t digit = 0; digit < digits; digit++)
+			{
+				for (size_t block = 0; block < blocks; block++)
+				{
+					const size_t digit_count = offsets[block * digits + digit];
+					offsets[block * digits + digit] = offset;
+					offset += digit_count;
+				}
+			}
+
+			parallel_for(blocks, [&](size_t begin, size_t end, unsigned int)
+			{
+				for (size_t block = begin; block < end; block++)
+				{
+					size_t* block_offsets = &offsets[block * digits];
+					const size_t last = std::min(count, (block + 1) * block_size);
+					for (size_t i = block * block_size; i < last; i++)
+					{
+						const size_t target = block_offsets[(keys[i] >> shift) & mask]++;
+						buffer[target] = keys[i];
+						if (values != nullptr)
+							value_buffer[target] = (*values)[i];
+					}
+				}
+			}, 1);
+			keys.swap(buffer);
+			if (values != nullptr)
+				values->swap(value_buffer);
+		}
+	}
+
+	/**
+	 * \brief Sorts keys by a range of their bits. (least significant digit radix sort, stable)
+	 * \param keys The keys.
+	 * \param first_bit The first bit of the sort key.
+	 * \param last_bit The bit after the last bit of the sort key.
+	 */
+	inline void radix_sort(std::vector<uint64_t>& keys, int first_bit = 0, int last_bit = 64)
+	{
+		radix_sort(keys, nullptr, first_bit, last_bit);
+	}
+
+	/**
+	 * \brief Sorts keys and moves values along with them. (least significant digit radix sort, stable)
+	 * \param keys The keys.
+	 * \param values The values. (one per key)
+	 * \param first_bit The first bit of the sort key.
+	 * \param last_bit The bit after the last bit of the sort key.
+	 */
+	inline void radix_sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, int first_bit = 0, int last_bit = 64)
+	{
+		radix_sort(keys, &values, first_bit, last_bit);
+	}
+}
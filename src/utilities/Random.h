@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Utilities
+{
+	/**
+	 * \brief Mixes the bits of a value, so that close values give unrelated results. (splitmix64 finalizer)
+	 * \param value The value.
+	 * \return The mixed bits.
+	 */
+	inline uint64_t mix_bits(uint64_t value)
+	{
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+		return value ^ (value >> 31);
+	}
+
+	/**
+	 * \brief Returns the key of a random stream, which 'random_bits' takes instead of the seed.
+	 * \param seed The seed of the stream.
+	 * \return The key.
+	 */
+	inline uint64_t random_stream(uint64_t seed)
+	{
+		return mix_bits(seed);
+	}
+
+	/**
+	 * \brief Returns the random bits at a position of a counter-based random stream.
+	 * Each number only depends on the stream and the counter, so threads can draw any part of a stream
+	 * and the results do not depend on the number of threads.
+	 * \param stream The key of the stream. (see 'random_stream')
+	 * \param counter The position in the stream.
+	 * \return The random bits.
+	 */
+	inline uint64_t random_bits(uint64_t stream, uint64_t counter)
+	{
+		return mix_bits(stream + counter * 0x9e3779b97f4a7c15ull);
+	}
+
+	/**
+	 * \brief Turns 24 random bits into a float in [0, 1).
+	 * \param bits The random bits. (only the lowest 24 are used)
+	 * \return The float.
+	 */
+	inline float to_unit_float(uint64_t bits)
+	{
+		return static_cast<float>(bits & 0xFFFFFFull) * (1.f / 16777216.f);
+	}
+}